@@ -0,0 +1,155 @@
+#!/usr/bin/env python
+
+##
+ # Copyright (c) 2016, Roland Bock
+ # All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without modification,
+ # are permitted provided that the following conditions are met:
+ #
+ #  * Redistributions of source code must retain the above copyright notice,
+ #    this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright notice,
+ #    this list of conditions and the following disclaimer in the documentation
+ #    and/or other materials provided with the distribution.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ # ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ # WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ # IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ # INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ # BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ # DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ # LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ # OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ # OF THE POSSIBILITY OF SUCH DAMAGE.
+ ##
+
+# Generates the sources of the compile time benchmarks:
+#   wide_<N>.sql     one table with N columns (run through ddl2cpp)
+#   joined.sql       tables to be joined
+#   select_all_<N>.cpp, where_depth_<D>.cpp, joins_<J>.cpp
+#
+# Usage: generate_benchmarks.py <output dir> <widths> <depths> <joins>, with comma separated lists of numbers
+
+from __future__ import print_function
+import os
+import sys
+
+COLUMN_TYPES = ["bigint", "varchar(255)", "double", "bool"]
+
+HEADER = """// generated by generate_benchmarks.py, do not edit
+#include "MockDb.h"
+#include <sqlpp11/sqlpp11.h>
+"""
+
+
+def column_type(index):
+    return COLUMN_TYPES[index % len(COLUMN_TYPES)]
+
+
+def condition(table, index):
+    """A comparison that matches the type of column <index>"""
+    column = "%s.col%d" % (table, index)
+    return [column + " > %d" % index,
+            column + " == \"%d\"" % index,
+            column + " < %d.5" % index,
+            column + " == true"][index % len(COLUMN_TYPES)]
+
+
+def write(path, text):
+    # Unchanged files are not touched, so that re-running cmake does not trigger a rebuild
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == text:
+                return
+    with open(path, "w") as f:
+        f.write(text)
+
+
+def wide_table(width):
+    columns = ",\n".join("\tcol_%d %s" % (i, column_type(i)) for i in range(width))
+    return "CREATE TABLE wide_%d\n(\n%s\n);\n" % (width, columns)
+
+
+def joined_tables(count):
+    return "".join("CREATE TABLE joined_%d\n(\n\tid bigint,\n\tparent bigint,\n\tname varchar(255)\n);\n\n" % i
+                   for i in range(count))
+
+
+def select_all(width):
+    return HEADER + """#include "wide_{w}.h"
+
+void select_all_{w}(MockDb& db)
+{{
+  const auto t = bench::Wide{w}{{}};
+  for (const auto& row : db(select(all_of(t)).from(t).where(t.col0 > 17)))
+  {{
+    (void)row.col0;
+    (void)row.col{last};
+  }}
+  db(insert_into(t).set(t.col0 = 17, t.col1 = "seventeen"));
+  db(update(t).set(t.col{last} = {last_value}).where(t.col0 == 17));
+}}
+""".format(w=width, last=width - 1, last_value=["17", "\"seventeen\"", "17.5", "true"][(width - 1) % 4])
+
+
+def where_depth(depth, width):
+    expression = condition("t", 0)
+    for i in range(1, depth):
+        operator = "and" if i % 2 else "or"
+        expression = "(%s %s %s)" % (condition("t", i % width), operator, expression)
+    return HEADER + """#include "wide_{w}.h"
+
+void where_depth_{d}(MockDb& db)
+{{
+  const auto t = bench::Wide{w}{{}};
+  for (const auto& row : db(select(t.col0).from(t).where({e})))
+  {{
+    (void)row.col0;
+  }}
+}}
+""".format(w=width, d=depth, e=expression)
+
+
+def joins(count):
+    tables = "\n".join("  const auto t%d = bench::Joined%d{};" % (i, i) for i in range(count))
+    joined = "t0" + "".join(".join(t%d).on(t%d.parent == t%d.id)" % (i, i, i - 1) for i in range(1, count))
+    return HEADER + """#include "joined.h"
+
+void joins_{j}(MockDb& db)
+{{
+{tables}
+  for (const auto& row : db(select(t0.id, t{last}.name).from({joined}).where(t0.id > 17)))
+  {{
+    (void)row.id;
+    (void)row.name;
+  }}
+}}
+""".format(j=count, tables=tables, last=count - 1, joined=joined)
+
+
+def main(argv):
+    if len(argv) != 5:
+        print(__doc__ or "usage: generate_benchmarks.py <output dir> <widths> <depths> <joins>", file=sys.stderr)
+        return 1
+    out = argv[1]
+    widths = [int(w) for w in argv[2].split(",")]
+    depths = [int(d) for d in argv[3].split(",")]
+    join_counts = [int(j) for j in argv[4].split(",")]
+    if not os.path.isdir(out):
+        os.makedirs(out)
+
+    for width in widths:
+        write(os.path.join(out, "wide_%d.sql" % width), wide_table(width))
+        write(os.path.join(out, "select_all_%d.cpp" % width), select_all(width))
+    for depth in depths:
+        write(os.path.join(out, "where_depth_%d.cpp" % depth), where_depth(depth, widths[0]))
+    write(os.path.join(out, "joined.sql"), joined_tables(max(join_counts)))
+    for count in join_counts:
+        write(os.path.join(out, "joins_%d.cpp" % count), joins(count))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,93 @@
+#!/usr/bin/env python
+
+##
+ # Copyright (c) 2016, Roland Bock
+ # All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without modification,
+ # are permitted provided that the following conditions are met:
+ #
+ #  * Redistributions of source code must retain the above copyright notice,
+ #    this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright notice,
+ #    this list of conditions and the following disclaimer in the documentation
+ #    and/or other materials provided with the distribution.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ # ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ # WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ # IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ # INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ # BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ # DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ # LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ # OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ # OF THE POSSIBILITY OF SUCH DAMAGE.
+ ##
+
+# Compiler launcher that measures the wall time and the peak memory of each compilation:
+#   measure_compile.py <result dir> <compiler command...>
+# writes one line "<object>,<seconds>,<peak MB>" per object file to <result dir>/<object name>.txt.
+#   measure_compile.py --report <result dir> <csv file>
+# collects these lines into a csv file and prints them.
+
+from __future__ import print_function
+import glob
+import os
+import resource
+import subprocess
+import sys
+import time
+
+
+def peak_megabytes():
+    peak = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+    # kilobytes on Linux, bytes on macOS
+    return peak / (1024.0 * 1024.0) if sys.platform == "darwin" else peak / 1024.0
+
+
+def measure(result_dir, command):
+    start = time.time()
+    status = subprocess.call(command)
+    seconds = time.time() - start
+    if status != 0:
+        return status
+
+    target = command[command.index("-o") + 1] if "-o" in command else command[-1]
+    name = os.path.basename(target)
+    line = "%s,%.2f,%.0f" % (name, seconds, peak_megabytes())
+    if not os.path.isdir(result_dir):
+        os.makedirs(result_dir)
+    with open(os.path.join(result_dir, name + ".txt"), "w") as f:
+        f.write(line + "\n")
+    print("compile time: " + line)
+    return 0
+
+
+def report(result_dir, csv_file):
+    lines = []
+    for path in sorted(glob.glob(os.path.join(result_dir, "*.txt"))):
+        with open(path) as f:
+            lines.extend(line.strip() for line in f if line.strip())
+    with open(csv_file, "w") as f:
+        f.write("object,seconds,peak_mb\n")
+        for line in lines:
+            f.write(line + "\n")
+    print("%-40s %10s %10s" % ("object", "seconds", "peak MB"))
+    for line in lines:
+        print("%-40s %10s %10s" % tuple(line.split(",")))
+    return 0
+
+
+def main(argv):
+    if len(argv) == 4 and argv[1] == "--report":
+        return report(argv[2], argv[3])
+    if len(argv) < 3:
+        print("usage: measure_compile.py <result dir> <compiler command...>", file=sys.stderr)
+        print("       measure_compile.py --report <result dir> <csv file>", file=sys.stderr)
+        return 1
+    return measure(argv[1], argv[2:])
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
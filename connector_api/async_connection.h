@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_DATABASE_ASYNC_CONNECTION_H
+#define SQLPP_DATABASE_ASYNC_CONNECTION_H
+
+#include <sqlpp11/async.h>
+#include <sqlpp11/database/connection.h>
+
+namespace sqlpp
+{
+  namespace database
+  {
+    // Optional extension of the connection interface, see connection.h
+    // Each call sends the statement and returns right away. The connector completes the returned handle
+    // via sqlpp::async_promise_t once the database has answered, typically on its own I/O thread.
+    class async_connection : public connection
+    {
+    public:
+      //! asynchronous "direct" select, the value is the same bind result as for select()
+      template <typename Select>
+      sqlpp::async_t<<< bind_result_t >>> async_select(const Select& s);
+
+      //! asynchronous "direct" insert
+      template <typename Insert>
+      sqlpp::async_t<size_t> async_insert(const Insert& i);
+
+      //! asynchronous "direct" update
+      template <typename Update>
+      sqlpp::async_t<size_t> async_update(const Update& u);
+
+      //! asynchronous "direct" remove
+      template <typename Remove>
+      sqlpp::async_t<size_t> async_remove(const Remove& r);
+
+      //! optional pipeline mode, used by sqlpp::pipeline()
+      // The async_* calls between begin_pipeline() and end_pipeline() are sent without waiting for results
+      // and are executed by the database in the order of the calls (e.g. libpq's pipeline mode).
+      // end_pipeline() sends the pending statements (if any) and returns without waiting for their results.
+      // Without these functions, pipelines execute their statements one after the other.
+      void begin_pipeline();
+      void end_pipeline();
+
+      //! returns a handle for the typed result, e.g. result_t<bind_result_t, ResultRow> for selects
+      // The handle offers get(), wait(), then() and can be co_await'ed in C++20.
+      template <typename T>
+      auto async(const T& t) -> decltype(sqlpp::async(*this, t))
+      {
+        return sqlpp::async(*this, t);
+      }
+    };
+  }
+}
+
+#endif
@@ -132,6 +132,12 @@ namespace sqlpp
       //! start transaction
       void start_transaction();
 
+      //! start transaction with isolation level and access mode hints (see sqlpp11/transaction.h)
+      void start_transaction(::sqlpp::isolation_level level, ::sqlpp::transaction_access access);
+
+      // Serialization failures, deadlocks and lock timeouts should be reported as ::sqlpp::transaction_conflict
+      // (or derived exceptions), so that sqlpp::run_transaction() can retry.
+
       //! commit transaction (or throw transaction if the transaction has been finished already)
       void commit_transaction();
 
@@ -141,6 +147,12 @@ namespace sqlpp
 
       //! report a rollback failure (will be called by transactions in case of a rollback failure in the destructor)
       void report_rollback_failure(const std::string message) noexcept;
+
+      //! optional: server side timeout for statements run with sqlpp::cancellable() (zero resets the timeout)
+      void set_statement_timeout(std::chrono::milliseconds timeout);
+
+      //! optional: cancel the running statement, called from another thread (see sqlpp11/cancellation.h)
+      void cancel();
     };
   }
 }
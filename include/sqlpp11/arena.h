@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_ARENA_H
+#define SQLPP_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <sqlpp11/detail/void.h>
+
+namespace sqlpp
+{
+  // Source of memory for the dynamic containers of statements and results.
+  class arena_t
+  {
+  public:
+    virtual ~arena_t() = default;
+
+    virtual void* allocate(std::size_t bytes, std::size_t alignment) = 0;
+    virtual void deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept = 0;
+  };
+
+  // Bump allocator: deallocate is a no-op, all memory is freed in one step by release() or the destructor.
+  class monotonic_arena_t : public arena_t
+  {
+    struct _block_deleter
+    {
+      void operator()(char* block) const
+      {
+        ::operator delete(block);
+      }
+    };
+    using _block_t = std::unique_ptr<char, _block_deleter>;
+
+    std::vector<_block_t> _blocks;
+    char* _buffer;
+    std::size_t _size;
+    std::size_t _used = 0;
+    std::size_t _next_block_size;
+
+  public:
+    monotonic_arena_t(std::size_t initial_block_size = 4096)
+        : _buffer(nullptr), _size(0), _next_block_size(initial_block_size ? initial_block_size : 1)
+    {
+    }
+
+    // Start with a user supplied buffer, e.g. on the stack, and continue on the heap once it is exhausted
+    monotonic_arena_t(void* buffer, std::size_t size)
+        : _buffer(static_cast<char*>(buffer)), _size(size), _next_block_size(size ? size : 4096)
+    {
+    }
+
+    monotonic_arena_t(const monotonic_arena_t&) = delete;
+    monotonic_arena_t(monotonic_arena_t&&) = delete;
+    monotonic_arena_t& operator=(const monotonic_arena_t&) = delete;
+    monotonic_arena_t& operator=(monotonic_arena_t&&) = delete;
+    ~monotonic_arena_t() = default;
+
+    void* allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      auto offset = _aligned_offset(alignment);
+      if (not _buffer or offset + bytes > _size)
+      {
+        _grow(bytes + alignment);
+        offset = _aligned_offset(alignment);
+      }
+      _used = offset + bytes;
+      return _buffer + offset;
+    }
+
+    void deallocate(void*, std::size_t, std::size_t) noexcept override
+    {
+    }
+
+    // Frees everything but the most recent block, which is reused
+    void release()
+    {
+      if (_blocks.size() > 1)
+      {
+        auto last = std::move(_blocks.back());
+        _blocks.clear();
+        _blocks.push_back(std::move(last));
+      }
+      _used = 0;
+    }
+
+    std::size_t bytes_used() const
+    {
+      return _used;
+    }
+
+  private:
+    std::size_t _aligned_offset(std::size_t alignment) const
+    {
+      const auto address = reinterpret_cast<std::uintptr_t>(_buffer) + _used;
+      return _used + (alignment - address % alignment) % alignment;
+    }
+
+    void _grow(std::size_t min_size)
+    {
+      while (_next_block_size < min_size)
+        _next_block_size *= 2;
+      _blocks.emplace_back(static_cast<char*>(::operator new(_next_block_size)));
+      _buffer = _blocks.back().get();
+      _size = _next_block_size;
+      _used = 0;
+      _next_block_size *= 2;
+    }
+  };
+
+  // Standard allocator that uses the given arena, or new/delete if there is none.
+  template <typename T>
+  struct arena_allocator
+  {
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+
+    arena_allocator() noexcept : _arena(nullptr)
+    {
+    }
+
+    explicit arena_allocator(arena_t* arena) noexcept : _arena(arena)
+    {
+    }
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U>& rhs) noexcept : _arena(rhs._arena)
+    {
+    }
+
+    // Copies use new/delete: they might be handed to other threads or outlive the original's arena
+    arena_allocator select_on_container_copy_construction() const noexcept
+    {
+      return {};
+    }
+
+    T* allocate(std::size_t n)
+    {
+      if (_arena)
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+      if (_arena)
+        _arena->deallocate(p, n * sizeof(T), alignof(T));
+      else
+        ::operator delete(p);
+    }
+
+    arena_t* _arena;
+  };
+
+  template <typename T, typename U>
+  bool operator==(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs)
+  {
+    return lhs._arena == rhs._arena;
+  }
+
+  template <typename T, typename U>
+  bool operator!=(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs)
+  {
+    return lhs._arena != rhs._arena;
+  }
+
+  namespace detail
+  {
+    // Moves the elements of the container into memory from the arena
+    template <typename Container>
+    void move_to_arena(Container& container, arena_t* arena)
+    {
+      const typename Container::allocator_type allocator(arena);
+      Container rebound(allocator);
+      rebound.reserve(container.size());
+      for (auto& element : container)
+      {
+        rebound.push_back(std::move(element));
+      }
+      container = std::move(rebound);
+    }
+
+    template <typename Data, typename Enable = void>
+    struct has_use_arena : std::false_type
+    {
+    };
+
+    template <typename Data>
+    struct has_use_arena<Data, void_t<decltype(std::declval<Data&>()._use_arena(std::declval<arena_t*>()))>>
+        : std::true_type
+    {
+    };
+
+    template <typename Data>
+    void use_arena(Data& data, arena_t* arena, std::true_type)
+    {
+      data._use_arena(arena);
+    }
+
+    template <typename Data>
+    void use_arena(Data&, arena_t*, std::false_type)
+    {
+    }
+
+    template <typename Data>
+    void use_arena(Data& data, arena_t* arena)
+    {
+      use_arena(data, arena, has_use_arena<Data>{});
+    }
+  }
+
+  // Lets the dynamic parts of a complete statement and the dynamic fields of its results allocate from the arena:
+  //   auto s = with_arena(arena, dynamic_select(db, t.alpha).from(t).dynamic_where());
+  //   s.where.add(t.beta == "cheesecake");
+  // The arena has to outlive the statement and its results. Copies of the statement, prepared statements and
+  // materialized rows use new/delete.
+  // Only the containers use the arena: The strings they hold (e.g. the names of dynamic columns and the text values
+  // of dynamic fields) are std::strings and allocate from the heap unless they fit into the small string buffer.
+  template <typename Statement>
+  Statement with_arena(arena_t& arena, Statement statement)
+  {
+    statement._use_arena(&arena);
+    return statement;
+  }
+}
+
+#endif
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_ASYNC_H
+#define SQLPP_ASYNC_H
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <sqlpp11/exception.h>
+#include <sqlpp11/result.h>
+#include <sqlpp11/type_traits.h>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+namespace sqlpp
+{
+  namespace detail
+  {
+    template <typename T>
+    struct async_state_t
+    {
+      std::mutex _mutex;
+      std::condition_variable _completed;
+      bool _ready = false;
+      std::unique_ptr<T> _value;
+      std::exception_ptr _exception;
+      std::function<void()> _continuation;
+
+      template <typename Complete>
+      void _complete(Complete complete)
+      {
+        std::function<void()> continuation;
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          if (_ready)
+            throw sqlpp::exception("async: result already set");
+          complete();
+          _ready = true;
+          continuation = std::move(_continuation);
+        }
+        _completed.notify_all();
+        if (continuation)
+          continuation();
+      }
+
+      // Returns false if the state is ready already, the continuation is not stored then
+      bool _set_continuation(std::function<void()> continuation)
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_ready)
+          return false;
+        _continuation = std::move(continuation);
+        return true;
+      }
+    };
+  }
+
+  template <typename T>
+  class async_promise_t;
+
+  // The completion handle of an asynchronously executed statement.
+  // Like std::future, the value can be obtained once, either via get(), then() or co_await.
+  template <typename T>
+  class async_t
+  {
+    std::shared_ptr<detail::async_state_t<T>> _state;
+
+    friend class async_promise_t<T>;
+
+    async_t(std::shared_ptr<detail::async_state_t<T>> state) : _state(std::move(state))
+    {
+    }
+
+  public:
+    using value_type = T;
+
+    async_t() = default;
+    async_t(const async_t&) = delete;
+    async_t(async_t&&) = default;
+    async_t& operator=(const async_t&) = delete;
+    async_t& operator=(async_t&&) = default;
+    ~async_t() = default;
+
+    bool valid() const
+    {
+      return _state != nullptr;
+    }
+
+    bool ready() const
+    {
+      std::lock_guard<std::mutex> lock(_state->_mutex);
+      return _state->_ready;
+    }
+
+    void wait() const
+    {
+      std::unique_lock<std::mutex> lock(_state->_mutex);
+      _state->_completed.wait(lock, [this] { return _state->_ready; });
+    }
+
+    template <typename Rep, typename Period>
+    bool wait_for(const std::chrono::duration<Rep, Period>& duration) const
+    {
+      std::unique_lock<std::mutex> lock(_state->_mutex);
+      return _state->_completed.wait_for(lock, duration, [this] { return _state->_ready; });
+    }
+
+    T get()
+    {
+      wait();
+      const auto state = std::move(_state);
+      if (state->_exception)
+        std::rethrow_exception(state->_exception);
+      return std::move(*state->_value);
+    }
+
+    // Calls callable with the value on the completing thread (or right away, if ready already)
+    template <typename Callable>
+    auto then(Callable callable) -> async_t<decltype(callable(std::declval<T>()))>
+    {
+      using _next_t = decltype(callable(std::declval<T>()));
+      async_promise_t<_next_t> promise;
+      auto next = promise.get_async();
+      const auto state = std::move(_state);
+      auto continuation = [state, promise, callable]() mutable
+      {
+        if (state->_exception)
+        {
+          promise.set_exception(state->_exception);
+          return;
+        }
+        try
+        {
+          promise.set_value(callable(std::move(*state->_value)));
+        }
+        catch (...)
+        {
+          promise.set_exception(std::current_exception());
+        }
+      };
+      if (not state->_set_continuation(continuation))
+        continuation();
+      return next;
+    }
+
+#if defined(__cpp_impl_coroutine)
+    bool await_ready() const
+    {
+      return ready();
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+      return _state->_set_continuation([handle]() { handle.resume(); });
+    }
+
+    T await_resume()
+    {
+      return get();
+    }
+#endif
+  };
+
+  // The producing side, used by connectors that implement the asynchronous connector interface
+  template <typename T>
+  class async_promise_t
+  {
+    std::shared_ptr<detail::async_state_t<T>> _state;
+
+  public:
+    async_promise_t() : _state(std::make_shared<detail::async_state_t<T>>())
+    {
+    }
+
+    async_t<T> get_async() const
+    {
+      return {_state};
+    }
+
+    void set_value(T value)
+    {
+      const auto& state = _state;
+      _state->_complete([&state, &value] { state->_value.reset(new T(std::move(value))); });
+    }
+
+    void set_exception(std::exception_ptr exception)
+    {
+      const auto& state = _state;
+      _state->_complete([&state, &exception] { state->_exception = exception; });
+    }
+  };
+
+  namespace detail
+  {
+    // Turns the connector's result-producing calls into their asynchronous counterparts.
+    // The defaulted template parameters keep sqlpp::async() SFINAE friendly for connectors without them.
+    template <typename Db>
+    struct async_dispatch_t
+    {
+      Db& _db;
+
+      template <typename Insert, typename D = Db>
+      auto insert(const Insert& i) -> decltype(std::declval<D&>().async_insert(i))
+      {
+        return _db.async_insert(i);
+      }
+
+      template <typename Update, typename D = Db>
+      auto update(const Update& u) -> decltype(std::declval<D&>().async_update(u))
+      {
+        return _db.async_update(u);
+      }
+
+      template <typename Remove, typename D = Db>
+      auto remove(const Remove& r) -> decltype(std::declval<D&>().async_remove(r))
+      {
+        return _db.async_remove(r);
+      }
+    };
+
+    template <typename Db, typename Select>
+    using async_select_result_t =
+        result_t<typename decltype(std::declval<Db&>().async_select(std::declval<const Select&>()))::value_type,
+                 typename Select::template _result_row_t<Db>>;
+
+    template <typename Db, typename Select>
+    auto async_run(Db& db, const Select& s, const std::true_type& /* has result row */)
+        -> async_t<async_select_result_t<Db, Select>>
+    {
+      using _result_t = async_select_result_t<Db, Select>;
+      using _db_result_t = typename decltype(db.async_select(s))::value_type;
+      const auto dynamic_names = s.get_dynamic_names();
+      return db.async_select(s).then([dynamic_names](_db_result_t db_result)
+                                     {
+                                       return _result_t{std::move(db_result), dynamic_names};
+                                     });
+    }
+
+    template <typename Db, typename Statement>
+    auto async_run(Db& db, const Statement& statement, const std::false_type& /* has result row */)
+        -> decltype(statement._run(std::declval<async_dispatch_t<Db>&>()))
+    {
+      async_dispatch_t<Db> dispatch{db};
+      return statement._run(dispatch);
+    }
+  }
+
+  // Executes the statement via the connector's asynchronous interface (async_select, async_insert, ...),
+  // see connector_api/async_connection.h. Selects yield the usual typed result.
+  template <typename Db, typename Statement>
+  auto async(Db& db, const Statement& statement)
+      -> decltype(detail::async_run(db, statement, has_result_row_t<Statement>{}))
+  {
+    using _run_check = run_check_t<typename Db::_serializer_context_t, Statement>;
+    _run_check{};
+    return detail::async_run(db, statement, has_result_row_t<Statement>{});
+  }
+
+  // Executes db(statement) on the given executor, e.g. a thread pool, for connectors without asynchronous interface.
+  // The executor is called with a std::function<void()>. The connection must not be used otherwise until completion.
+  template <typename Db, typename Statement, typename Executor>
+  auto async(Db& db, const Statement& statement, Executor&& executor) -> async_t<decltype(db(statement))>
+  {
+    using _result_t = decltype(db(statement));
+    async_promise_t<_result_t> promise;
+    auto result = promise.get_async();
+    std::function<void()> task = [&db, statement, promise]() mutable
+    {
+      try
+      {
+        promise.set_value(db(statement));
+      }
+      catch (...)
+      {
+        promise.set_exception(std::current_exception());
+      }
+    };
+    executor(std::move(task));
+    return result;
+  }
+}
+
+#endif
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_CACHING_CONNECTION_H
+#define SQLPP_CACHING_CONNECTION_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sqlpp11/connection.h>
+#include <sqlpp11/fingerprint.h>
+#include <sqlpp11/materialized_result.h>
+#include <sqlpp11/prepared_select.h>
+#include <sqlpp11/serialize.h>
+#include <sqlpp11/serializer_context.h>
+#include <sqlpp11/statement.h>
+#include <sqlpp11/statement_shape.h>
+#include <sqlpp11/transaction.h>
+#include <sqlpp11/type_traits.h>
+#include <sqlpp11/detail/type_set.h>
+
+namespace sqlpp
+{
+  struct result_cache_config_t
+  {
+    std::chrono::milliseconds ttl = std::chrono::milliseconds{1000};
+    std::size_t max_bytes = 16 * 1024 * 1024;
+  };
+
+  struct result_cache_metrics_t
+  {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t invalidations = 0;
+    std::size_t evictions = 0;
+  };
+
+  namespace detail
+  {
+    template <typename... Tables>
+    std::vector<std::size_t> cached_table_ids(const type_set<Tables...>&)
+    {
+      return {type_id<Tables>()...};
+    }
+
+    // Reads that bypass the cache (prepared selects, custom queries)
+    template <typename T>
+    struct is_uncached_read : std::integral_constant<bool, has_result_row_t<T>::value and not is_statement_t<T>::value>
+    {
+    };
+
+    template <typename Database, typename Statement, typename Composite>
+    struct is_uncached_read<prepared_select_t<Database, Statement, Composite>> : std::true_type
+    {
+    };
+
+    struct cached_bytes_t
+    {
+      std::size_t bytes = 0;
+
+      template <typename Field>
+      void operator()(const Field& field)
+      {
+        bytes += _dynamic_bytes(field._value);
+      }
+
+      static std::size_t _dynamic_bytes(const std::string& value)
+      {
+        return value.capacity();
+      }
+
+      template <typename Value>
+      static std::size_t _dynamic_bytes(const Value&)
+      {
+        return 0;
+      }
+    };
+  }
+
+  // Caches the rows of selects (see materialized_result.h), keyed by their serialized SQL, for the configured time and
+  // up to the memory budget (least recently used entries are evicted first).
+  // Inserts, updates and removes invalidate the entries that use any of the statement's tables. Statements whose
+  // tables are unknown (e.g. execute() or custom queries) invalidate all entries. Tables that are only referenced in
+  // dynamic parts of a statement are not tracked, use invalidate() or rely on the TTL for those.
+  // Changes by other connections are only covered by the TTL.
+  // Within transactions, selects bypass the cache. Like a connection, the cache must not be used by several threads
+  // at the same time.
+  template <typename Db>
+  class caching_connection : public sqlpp::connection
+  {
+    using _clock_t = std::chrono::steady_clock;
+
+    struct _entry_t
+    {
+      std::shared_ptr<const void> _rows;
+      std::size_t _row_type;
+      std::vector<std::size_t> _tables;
+      _clock_t::time_point _expires;
+      std::size_t _bytes;
+      std::list<std::string>::iterator _lru;
+    };
+
+    Db& _db;
+    result_cache_config_t _config;
+    std::unordered_map<std::string, _entry_t> _entries;
+    std::list<std::string> _lru;  // most recently used first
+    std::size_t _bytes = 0;
+    std::size_t _open_transactions = 0;
+    result_cache_metrics_t _metrics;
+
+    template <typename Statement>
+    using _result_row_t = typename Statement::template _result_row_t<Db>;
+
+    template <typename Select>
+    using _cached_result_t = materialized_result_t<_result_row_t<Select>>;
+
+    void _end_transaction()
+    {
+      if (_open_transactions > 0)
+        --_open_transactions;
+    }
+
+    void _erase(typename std::unordered_map<std::string, _entry_t>::iterator it)
+    {
+      _bytes -= it->second._bytes;
+      _lru.erase(it->second._lru);
+      _entries.erase(it);
+    }
+
+    void _invalidate(const std::vector<std::size_t>& tables)
+    {
+      if (tables.empty())
+      {
+        _metrics.invalidations += _entries.size();
+        clear();
+        return;
+      }
+      for (auto it = _entries.begin(); it != _entries.end();)
+      {
+        const auto& entry_tables = it->second._tables;
+        const auto uses_table = std::find_first_of(entry_tables.begin(), entry_tables.end(), tables.begin(),
+                                                   tables.end()) != entry_tables.end();
+        if (uses_table)
+        {
+          ++_metrics.invalidations;
+          _erase(it++);
+        }
+        else
+          ++it;
+      }
+    }
+
+    template <typename Row>
+    std::shared_ptr<const std::vector<Row>> _lookup(const std::string& key)
+    {
+      const auto it = _entries.find(key);
+      if (it == _entries.end())
+        return nullptr;
+      if (it->second._row_type != detail::type_id<Row>() or it->second._expires <= _clock_t::now())
+      {
+        _erase(it);
+        return nullptr;
+      }
+      _lru.splice(_lru.begin(), _lru, it->second._lru);
+      return std::static_pointer_cast<const std::vector<Row>>(it->second._rows);
+    }
+
+    template <typename Row>
+    void _store(const std::string& key, std::shared_ptr<const std::vector<Row>> rows, std::vector<std::size_t> tables)
+    {
+      auto bytes = key.size() + sizeof(_entry_t) + rows->size() * sizeof(Row);
+      for (const auto& row : *rows)
+      {
+        detail::cached_bytes_t counter;
+        row._apply(counter);
+        bytes += counter.bytes;
+      }
+      if (bytes > _config.max_bytes)
+        return;
+
+      while (_bytes + bytes > _config.max_bytes)
+      {
+        ++_metrics.evictions;
+        _erase(_entries.find(_lru.back()));
+      }
+      _lru.push_front(key);
+      _entries.emplace(key, _entry_t{std::move(rows), detail::type_id<Row>(), std::move(tables),
+                                     _clock_t::now() + _config.ttl, bytes, _lru.begin()});
+      _bytes += bytes;
+    }
+
+    template <typename Select>
+    auto _run(const Select& s, const std::true_type& /* is cached read */, const std::false_type&)
+        -> _cached_result_t<Select>
+    {
+      using _row_t = _result_row_t<Select>;
+      if (_open_transactions)
+        return materialize(_db, s);
+
+      std::ostringstream os;
+      serializer_context_t context{os};
+      serialize(s, context);
+      const auto key = os.str();
+
+      auto rows = _lookup<_row_t>(key);
+      if (rows)
+        ++_metrics.hits;
+      else
+      {
+        ++_metrics.misses;
+        rows = detail::materialize_rows(_db, s);
+        _store(key, rows, detail::cached_table_ids(typename detail::tables_of<Select>::type{}));
+      }
+      return {detail::materialized_db_result_t<_row_t>{std::move(rows)}, s.get_dynamic_names()};
+    }
+
+    template <typename T>
+    auto _run(const T& t, const std::false_type&, const std::true_type& /* is uncached read */)
+        -> decltype(std::declval<Db&>()(t))
+    {
+      return _db(t);
+    }
+
+    template <typename T>
+    auto _run(const T& t, const std::false_type&, const std::false_type&) -> decltype(std::declval<Db&>()(t))
+    {
+      // single threaded: invalidating before the change is as good as afterwards, and exception safe
+      _invalidate(detail::cached_table_ids(typename detail::tables_of<T>::type{}));
+      return _db(t);
+    }
+
+  public:
+    using _traits = typename Db::_traits;
+    using _serializer_context_t = typename Db::_serializer_context_t;
+    using _interpreter_context_t = typename Db::_interpreter_context_t;
+    using _prepared_statement_t = typename Db::_prepared_statement_t;
+
+    template <typename T>
+    using _is_cached_read_t = logic::all_t<is_statement_t<T>::value, has_result_row_t<T>::value>;
+
+    caching_connection(Db& db, result_cache_config_t config = {}) : _db(db), _config(config)
+    {
+    }
+
+    caching_connection(const caching_connection&) = delete;
+    caching_connection(caching_connection&&) = delete;
+    caching_connection& operator=(const caching_connection&) = delete;
+    caching_connection& operator=(caching_connection&&) = delete;
+    ~caching_connection() = default;
+
+    template <typename T>
+    static _serializer_context_t& _serialize_interpretable(const T& t, _serializer_context_t& context)
+    {
+      return Db::_serialize_interpretable(t, context);
+    }
+
+    template <typename T>
+    static _interpreter_context_t& _interpret_interpretable(const T& t, _interpreter_context_t& context)
+    {
+      return Db::_interpret_interpretable(t, context);
+    }
+
+    Db& connection()
+    {
+      return _db;
+    }
+
+    template <typename T>
+    auto operator()(const T& t) -> decltype(this->_run(t, _is_cached_read_t<T>{}, detail::is_uncached_read<T>{}))
+    {
+      return _run(t, _is_cached_read_t<T>{}, detail::is_uncached_read<T>{});
+    }
+
+    template <typename T>
+    auto prepare(const T& t) -> decltype(std::declval<Db&>().prepare(t))
+    {
+      return _db.prepare(t);
+    }
+
+    template <typename Statement>
+    auto execute(const Statement& s) -> decltype(std::declval<Db&>().execute(s))
+    {
+      _invalidate({});
+      return _db.execute(s);
+    }
+
+    // Removes all entries that use the table
+    template <typename Table>
+    void invalidate(const Table&)
+    {
+      static_assert(is_table_t<Table>::value, "invalidate() requires a table");
+      _invalidate(detail::cached_table_ids(typename detail::tables_of<Table>::type{}));
+    }
+
+    void clear()
+    {
+      _entries.clear();
+      _lru.clear();
+      _bytes = 0;
+    }
+
+    std::size_t size() const
+    {
+      return _entries.size();
+    }
+
+    std::size_t bytes_used() const
+    {
+      return _bytes;
+    }
+
+    const result_cache_metrics_t& metrics() const
+    {
+      return _metrics;
+    }
+
+    void start_transaction()
+    {
+      _db.start_transaction();
+      ++_open_transactions;
+    }
+
+    void start_transaction(isolation_level level, transaction_access access)
+    {
+      _db.start_transaction(level, access);
+      ++_open_transactions;
+    }
+
+    // A failed commit leaves the transaction open, it is rolled back afterwards (e.g. by transaction_t)
+    void commit_transaction()
+    {
+      _db.commit_transaction();
+      _end_transaction();
+    }
+
+    // A failed rollback ends the transaction, too, nobody is going to finish it
+    void rollback_transaction(bool report)
+    {
+      try
+      {
+        _db.rollback_transaction(report);
+      }
+      catch (...)
+      {
+        _end_transaction();
+        throw;
+      }
+      _end_transaction();
+    }
+
+    void report_rollback_failure(const std::string& message) noexcept
+    {
+      _db.report_rollback_failure(message);
+    }
+  };
+}
+
+#endif
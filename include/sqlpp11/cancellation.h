@@ -0,0 +1,460 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_CANCELLATION_H
+#define SQLPP_CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <sqlpp11/data_types/no_value.h>
+#include <sqlpp11/exception.h>
+#include <sqlpp11/type_traits.h>
+#include <sqlpp11/detail/void.h>
+
+namespace sqlpp
+{
+  class statement_cancelled : public exception
+  {
+  public:
+    statement_cancelled(const std::string& what_arg) : exception(what_arg)
+    {
+    }
+  };
+
+  namespace detail
+  {
+    struct cancellation_state_t
+    {
+      using _clock_t = std::chrono::steady_clock;
+
+      cancellation_state_t(_clock_t::time_point deadline) : _deadline(deadline)
+      {
+      }
+
+      const _clock_t::time_point _deadline;
+      std::atomic<bool> _cancelled{false};
+      std::mutex _mutex;
+      std::size_t _last_callback_id = 0;
+      std::map<std::size_t, std::function<void()>> _callbacks;
+
+      void _cancel()
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_cancelled.exchange(true))
+          return;
+        for (const auto& callback : _callbacks)
+        {
+          callback.second();
+        }
+      }
+    };
+  }
+
+  // Tells a statement to stop, either at a deadline or when the cancellation_source_t is cancelled.
+  // Default constructed tokens never fire. Tokens are cheap to copy and can be shared between threads.
+  class cancellation_token_t
+  {
+  public:
+    using _clock_t = std::chrono::steady_clock;
+
+    cancellation_token_t() = default;
+
+    cancellation_token_t(std::shared_ptr<detail::cancellation_state_t> state) : _state(std::move(state))
+    {
+    }
+
+    static cancellation_token_t at(_clock_t::time_point deadline)
+    {
+      return {std::make_shared<detail::cancellation_state_t>(deadline)};
+    }
+
+    template <typename Rep, typename Period>
+    static cancellation_token_t after(std::chrono::duration<Rep, Period> timeout)
+    {
+      return at(_clock_t::now() + std::chrono::duration_cast<_clock_t::duration>(timeout));
+    }
+
+    bool has_deadline() const
+    {
+      return _state and _state->_deadline != _clock_t::time_point::max();
+    }
+
+    _clock_t::time_point deadline() const
+    {
+      return _state ? _state->_deadline : _clock_t::time_point::max();
+    }
+
+    // Time until the deadline, at least one millisecond unless the deadline has passed
+    std::chrono::milliseconds remaining() const
+    {
+      const auto now = _clock_t::now();
+      if (not has_deadline())
+        return std::chrono::milliseconds::max();
+      if (now >= deadline())
+        return std::chrono::milliseconds{0};
+      const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline() - now);
+      return remaining.count() ? remaining : std::chrono::milliseconds{1};
+    }
+
+    bool is_cancelled() const
+    {
+      return _state and (_state->_cancelled or _clock_t::now() >= _state->_deadline);
+    }
+
+    void throw_if_cancelled() const
+    {
+      if (not _state)
+        return;
+      if (_state->_cancelled)
+        throw statement_cancelled("statement cancelled");
+      if (_clock_t::now() >= _state->_deadline)
+        throw statement_cancelled("statement deadline exceeded");
+    }
+
+    // Calls the callback (from the thread that cancels) while the registration is alive, see cancellation_source_t.
+    // Deadlines do not trigger callbacks.
+    class registration_t
+    {
+      std::shared_ptr<detail::cancellation_state_t> _state;
+      std::size_t _id = 0;
+
+    public:
+      registration_t() = default;
+
+      registration_t(std::shared_ptr<detail::cancellation_state_t> state, std::function<void()> callback)
+          : _state(std::move(state))
+      {
+        if (not _state)
+          return;
+        std::lock_guard<std::mutex> lock(_state->_mutex);
+        if (_state->_cancelled)
+        {
+          callback();
+          return;
+        }
+        _id = ++_state->_last_callback_id;
+        _state->_callbacks.emplace(_id, std::move(callback));
+      }
+
+      registration_t(const registration_t&) = delete;
+      registration_t(registration_t&& rhs) : _state(std::move(rhs._state)), _id(rhs._id)
+      {
+        rhs._id = 0;
+      }
+      registration_t& operator=(const registration_t&) = delete;
+      registration_t& operator=(registration_t&&) = delete;
+
+      // Waits for a running callback to finish
+      ~registration_t()
+      {
+        if (_state and _id)
+        {
+          std::lock_guard<std::mutex> lock(_state->_mutex);
+          _state->_callbacks.erase(_id);
+        }
+      }
+    };
+
+    registration_t on_cancel(std::function<void()> callback) const
+    {
+      return {_state, std::move(callback)};
+    }
+
+  private:
+    std::shared_ptr<detail::cancellation_state_t> _state;
+  };
+
+  // Cancels statements from another thread
+  class cancellation_source_t
+  {
+  public:
+    using _clock_t = cancellation_token_t::_clock_t;
+
+    cancellation_source_t(_clock_t::time_point deadline = _clock_t::time_point::max())
+        : _state(std::make_shared<detail::cancellation_state_t>(deadline))
+    {
+    }
+
+    cancellation_token_t token() const
+    {
+      return {_state};
+    }
+
+    void cancel()
+    {
+      _state->_cancel();
+    }
+
+  private:
+    std::shared_ptr<detail::cancellation_state_t> _state;
+  };
+
+  // Stops iterating over a result by throwing statement_cancelled when the token fires
+  template <typename Result>
+  class cancellable_result_t
+  {
+    Result _result;
+    cancellation_token_t _token;
+
+  public:
+    cancellable_result_t(Result result, cancellation_token_t token)
+        : _result(std::move(result)), _token(std::move(token))
+    {
+    }
+
+    cancellable_result_t(const cancellable_result_t&) = delete;
+    cancellable_result_t(cancellable_result_t&&) = default;
+    cancellable_result_t& operator=(const cancellable_result_t&) = delete;
+    cancellable_result_t& operator=(cancellable_result_t&&) = default;
+
+    class iterator
+    {
+      using _iterator_t = decltype(std::declval<Result&>().begin());
+
+      _iterator_t _it;
+      const cancellation_token_t* _token;
+
+    public:
+      using iterator_category = typename std::iterator_traits<_iterator_t>::iterator_category;
+      using value_type = typename std::iterator_traits<_iterator_t>::value_type;
+      using pointer = typename std::iterator_traits<_iterator_t>::pointer;
+      using reference = typename std::iterator_traits<_iterator_t>::reference;
+      using difference_type = typename std::iterator_traits<_iterator_t>::difference_type;
+
+      iterator(_iterator_t it, const cancellation_token_t& token) : _it(it), _token(&token)
+      {
+      }
+
+      reference operator*() const
+      {
+        return *_it;
+      }
+
+      pointer operator->() const
+      {
+        return _it.operator->();
+      }
+
+      bool operator==(const iterator& rhs) const
+      {
+        return _it == rhs._it;
+      }
+
+      bool operator!=(const iterator& rhs) const
+      {
+        return not(operator==(rhs));
+      }
+
+      iterator& operator++()
+      {
+        _token->throw_if_cancelled();
+        ++_it;
+        return *this;
+      }
+    };
+
+    iterator begin()
+    {
+      _token.throw_if_cancelled();
+      return {_result.begin(), _token};
+    }
+
+    iterator end()
+    {
+      return {_result.end(), _token};
+    }
+
+    auto front() const -> decltype(std::declval<const Result&>().front())
+    {
+      return _result.front();
+    }
+
+    bool empty() const
+    {
+      return _result.empty();
+    }
+
+    void pop_front()
+    {
+      _token.throw_if_cancelled();
+      _result.pop_front();
+    }
+  };
+
+  namespace detail
+  {
+    template <typename Db, typename Enable = void>
+    struct has_statement_timeout : std::false_type
+    {
+    };
+
+    template <typename Db>
+    struct has_statement_timeout<
+        Db,
+        void_t<decltype(std::declval<Db&>().set_statement_timeout(std::chrono::milliseconds{}))>> : std::true_type
+    {
+    };
+
+    template <typename Db, typename Enable = void>
+    struct has_cancel : std::false_type
+    {
+    };
+
+    template <typename Db>
+    struct has_cancel<Db, void_t<decltype(std::declval<Db&>().cancel())>> : std::true_type
+    {
+    };
+
+    // Connector hook: server side timeout for the duration of the execution
+    template <typename Db, bool = has_statement_timeout<Db>::value>
+    struct statement_timeout_guard_t
+    {
+      statement_timeout_guard_t(Db&, const cancellation_token_t&)
+      {
+      }
+    };
+
+    template <typename Db>
+    struct statement_timeout_guard_t<Db, true>
+    {
+      Db* _db = nullptr;
+
+      statement_timeout_guard_t(Db& db, const cancellation_token_t& token)
+      {
+        if (token.has_deadline())
+        {
+          db.set_statement_timeout(token.remaining());
+          _db = &db;
+        }
+      }
+
+      statement_timeout_guard_t(const statement_timeout_guard_t&) = delete;
+      statement_timeout_guard_t& operator=(const statement_timeout_guard_t&) = delete;
+
+      ~statement_timeout_guard_t()
+      {
+        if (_db)
+        {
+          try
+          {
+            _db->set_statement_timeout(std::chrono::milliseconds{0});
+          }
+          catch (...)
+          {
+          }
+        }
+      }
+    };
+
+    // Connector hook: db.cancel() is called from the cancelling thread during the execution
+    template <typename Db>
+    cancellation_token_t::registration_t register_cancel(Db& db,
+                                                         const cancellation_token_t& token,
+                                                         const std::true_type&)
+    {
+      return token.on_cancel([&db] { db.cancel(); });
+    }
+
+    template <typename Db>
+    cancellation_token_t::registration_t register_cancel(Db&, const cancellation_token_t&, const std::false_type&)
+    {
+      return {};
+    }
+
+    template <typename Result>
+    Result make_cancellable_result(Result result, const cancellation_token_t&, const std::false_type& /* is result */)
+    {
+      return result;
+    }
+
+    template <typename Result>
+    cancellable_result_t<Result> make_cancellable_result(Result result,
+                                                         const cancellation_token_t& token,
+                                                         const std::true_type& /* is result */)
+    {
+      return {std::move(result), token};
+    }
+
+    template <typename Result>
+    using cancellable_result_type_t =
+        typename std::conditional<std::is_class<Result>::value, cancellable_result_t<Result>, Result>::type;
+  }
+
+  // A statement or prepared statement to be executed with a cancellation token, e.g.
+  //   db(cancellable(select(...), cancellation_token_t::after(std::chrono::seconds{2})));
+  // The statement is not sent if the token has already fired. Connectors may offer
+  //   void set_statement_timeout(std::chrono::milliseconds timeout); // zero resets the timeout
+  //   void cancel(); // called from the cancelling thread while the statement is executed
+  // Iterating over the result throws statement_cancelled once the token fires.
+  template <typename Statement>
+  struct cancellable_t
+  {
+    using _traits = make_traits<no_value_t, tag::is_prepared_statement>;
+    using _nodes = detail::type_vector<>;
+
+    using _run_check = consistent_t;
+
+    cancellable_t(Statement statement, cancellation_token_t token)
+        : _statement(std::move(statement)), _token(std::move(token))
+    {
+    }
+
+    template <typename Db>
+    auto _run(Db& db) const -> detail::cancellable_result_type_t<decltype(std::declval<const Statement&>()._run(db))>
+    {
+      using _result_t = decltype(_statement._run(db));
+      using _check = run_check_t<typename Db::_serializer_context_t, Statement>;
+      _check{};
+
+      _token.throw_if_cancelled();
+      const detail::statement_timeout_guard_t<Db> timeout_guard(db, _token);
+      const auto registration = detail::register_cancel(db, _token, detail::has_cancel<Db>{});
+      // The token might have fired before the cancel hook was registered
+      _token.throw_if_cancelled();
+      return detail::make_cancellable_result(_statement._run(db), _token,
+                                             std::integral_constant<bool, std::is_class<_result_t>::value>{});
+    }
+
+    Statement _statement;
+    cancellation_token_t _token;
+  };
+
+  template <typename Statement>
+  cancellable_t<Statement> cancellable(Statement statement, cancellation_token_t token)
+  {
+    return {std::move(statement), std::move(token)};
+  }
+}
+
+#endif
@@ -27,32 +27,108 @@
 #ifndef SQLPP_CHAR_SEQUENCE_H
 #define SQLPP_CHAR_SEQUENCE_H
 
+#include <cstddef>
+#include <cstdint>
 #include <sqlpp11/detail/index_sequence.h>
 
 namespace sqlpp
 {
+  // char_ptr() of char_sequence and packed_name is constexpr, so names can be used in constant expressions
   template <char... Cs>
   struct char_sequence
   {
-    static const char* char_ptr()
+    static constexpr const char* char_ptr()
     {
-      static char s[] = {Cs...};
-      return s;
+      return _text;
+    }
+
+  private:
+    static constexpr char _text[] = {Cs...};
+  };
+
+  template <char... Cs>
+  constexpr char char_sequence<Cs...>::_text[];
+
+  namespace detail
+  {
+    template <std::size_t Size>
+    struct name_buffer
+    {
+      char data[Size];
     };
+
+    constexpr std::uint64_t nth_name_chunk(std::size_t)
+    {
+      return 0;
+    }
+
+    template <typename... Rest>
+    constexpr std::uint64_t nth_name_chunk(std::size_t n, std::uint64_t first, Rest... rest)
+    {
+      return n == 0 ? first : nth_name_chunk(n - 1, rest...);
+    }
+
+    template <std::uint64_t... Chunks>
+    constexpr char unpack_name_char(std::size_t i)
+    {
+      return static_cast<char>((nth_name_chunk(i / 8, Chunks...) >> (8 * (i % 8))) & 0xff);
+    }
+
+    template <std::size_t Size, std::uint64_t... Chunks, std::size_t... Is>
+    constexpr name_buffer<Size> unpack_name(index_sequence<Is...>)
+    {
+      return {{unpack_name_char<Chunks...>(Is)...}};
+    }
+
+    template <std::size_t N, const char (&s)[N]>
+    constexpr std::uint64_t pack_name_char(std::size_t i)
+    {
+      return i < N ? static_cast<std::uint64_t>(static_cast<unsigned char>(s[i])) : 0;
+    }
+
+    template <std::size_t N, const char (&s)[N]>
+    constexpr std::uint64_t pack_name_chunk(std::size_t offset, std::size_t k = 0)
+    {
+      return k == 8 ? 0 : (pack_name_char<N, s>(offset + k) << (8 * k)) | pack_name_chunk<N, s>(offset, k + 1);
+    }
+  }
+
+  // Name with eight characters per template argument (including the terminating zero).
+  // Like char_sequence, equal names yield the same type, but mangled names and debug info are much shorter.
+  template <std::size_t Size, std::uint64_t... Chunks>
+  struct packed_name
+  {
+    static constexpr std::size_t size()
+    {
+      return Size - 1;
+    }
+
+    static constexpr const char* char_ptr()
+    {
+      return _text.data;
+    }
+
+  private:
+    static constexpr detail::name_buffer<Size> _text =
+        detail::unpack_name<Size, Chunks...>(detail::make_index_sequence<Size>{});
   };
 
-  template <std::size_t N, const char(&s)[N], typename T>
+  template <std::size_t Size, std::uint64_t... Chunks>
+  constexpr detail::name_buffer<Size> packed_name<Size, Chunks...>::_text;
+
+  template <std::size_t N, const char (&s)[N], typename T>
   struct make_char_sequence_impl;
 
-  template <std::size_t N, const char(&s)[N], std::size_t... i>
+  template <std::size_t N, const char (&s)[N], std::size_t... i>
   struct make_char_sequence_impl<N, s, sqlpp::detail::index_sequence<i...>>
   {
-    using type = char_sequence<s[i]...>;
+    using type = packed_name<N, detail::pack_name_chunk<N, s>(8 * i)...>;
   };
 
-  template <std::size_t N, const char(&Input)[N]>
+  // Despite its name, this yields a packed_name (one template argument per eight characters).
+  template <std::size_t N, const char (&Input)[N]>
   using make_char_sequence =
-      typename make_char_sequence_impl<sizeof(Input), Input, sqlpp::detail::make_index_sequence<sizeof(Input)>>::type;
+      typename make_char_sequence_impl<sizeof(Input), Input, sqlpp::detail::make_index_sequence<(N + 7) / 8>>::type;
 }
 
 #endif
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_CONNECTION_POOL_H
+#define SQLPP_CONNECTION_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sqlpp11/exception.h>
+#include <sqlpp11/statement_template.h>
+
+namespace sqlpp
+{
+  struct connection_pool_config_t
+  {
+    std::size_t max_size = 8;
+    // How long acquire() waits for a connection to be returned before throwing
+    std::chrono::milliseconds wait_timeout = std::chrono::milliseconds(5000);
+    // Idle connections are validated before being handed out again after this time
+    std::chrono::milliseconds validate_after = std::chrono::milliseconds(30000);
+  };
+
+  struct connection_pool_metrics_t
+  {
+    std::size_t leases_in_use;
+    std::size_t total_leases;
+    std::size_t waits;
+    std::size_t timeouts;
+    std::chrono::microseconds total_wait_time;
+    std::size_t connections_created;
+    std::size_t connections_dropped;
+    std::size_t validation_failures;
+  };
+
+  // A fixed number of connection slots, handed out as RAII leases.
+  // Leasing and returning do not take a lock: Slots are claimed by a linear compare-and-swap scan over the slots,
+  // starting at each thread's preferred slot, so that it tends to get the same connection (with warm caches) again.
+  // Only threads that have to wait for a connection to be returned use a mutex.
+  template <typename Connection>
+  class connection_pool
+  {
+  public:
+    using _connection_t = Connection;
+    using _factory_t = std::function<std::unique_ptr<Connection>()>;
+    using _validator_t = std::function<bool(Connection&)>;
+    using _clock_t = std::chrono::steady_clock;
+
+  private:
+    enum slot_state : int
+    {
+      slot_empty,
+      slot_idle,
+      slot_leased,
+    };
+
+    struct _slot_t
+    {
+      std::atomic<int> _state{slot_empty};
+      std::unique_ptr<Connection> _connection;
+      prepared_statement_cache_t<Connection> _prepared_statements;
+      _clock_t::time_point _last_used;
+    };
+
+    const connection_pool_config_t _config;
+    const _factory_t _factory;
+    const _validator_t _validator;
+    std::unique_ptr<_slot_t[]> _slots;
+
+    std::mutex _wait_mutex;
+    std::condition_variable _returned;
+    std::atomic<std::size_t> _waiting{0};
+
+    std::atomic<std::size_t> _leases_in_use{0};
+    std::atomic<std::size_t> _total_leases{0};
+    std::atomic<std::size_t> _waits{0};
+    std::atomic<std::size_t> _timeouts{0};
+    std::atomic<std::size_t> _wait_time_us{0};
+    std::atomic<std::size_t> _connections_created{0};
+    std::atomic<std::size_t> _connections_dropped{0};
+    std::atomic<std::size_t> _validation_failures{0};
+
+  public:
+    class lease_t
+    {
+      connection_pool* _pool;
+      _slot_t* _slot;
+
+    public:
+      lease_t(connection_pool& pool, _slot_t& slot) : _pool(&pool), _slot(&slot)
+      {
+      }
+
+      lease_t(const lease_t&) = delete;
+      lease_t(lease_t&& rhs) noexcept : _pool(rhs._pool), _slot(rhs._slot)
+      {
+        rhs._slot = nullptr;
+      }
+      lease_t& operator=(const lease_t&) = delete;
+      lease_t& operator=(lease_t&& rhs) noexcept
+      {
+        if (this != &rhs)
+        {
+          release();
+          _pool = rhs._pool;
+          _slot = rhs._slot;
+          rhs._slot = nullptr;
+        }
+        return *this;
+      }
+
+      ~lease_t()
+      {
+        release();
+      }
+
+      Connection& operator*() const
+      {
+        return *_slot->_connection;
+      }
+
+      Connection* operator->() const
+      {
+        return _slot->_connection.get();
+      }
+
+      template <typename T>
+      auto operator()(const T& t) const -> decltype(std::declval<Connection&>()(t))
+      {
+        return (*_slot->_connection)(t);
+      }
+
+      template <typename T>
+      auto prepare(const T& t) const -> decltype(std::declval<Connection&>().prepare(t))
+      {
+        return _slot->_connection->prepare(t);
+      }
+
+      // Prepared statements survive the lease and are re-used by the next lease of the same connection
+      template <typename Statement>
+      auto bind(const statement_template_t<Statement>& t) const
+          -> decltype(std::declval<prepared_statement_cache_t<Connection>&>().bind(std::declval<Connection&>(), t))
+      {
+        return _slot->_prepared_statements.bind(*_slot->_connection, t);
+      }
+
+      // The connection is broken (e.g. after an exception) and must not be re-used
+      void invalidate()
+      {
+        if (_slot)
+        {
+          _pool->_drop(*_slot);
+          _pool->_return(*_slot);
+          _slot = nullptr;
+        }
+      }
+
+      void release()
+      {
+        if (_slot)
+        {
+          _pool->_return(*_slot);
+          _slot = nullptr;
+        }
+      }
+    };
+
+    connection_pool(connection_pool_config_t config, _factory_t factory, _validator_t validator = {})
+        : _config(config),
+          _factory(std::move(factory)),
+          _validator(std::move(validator)),
+          _slots(new _slot_t[config.max_size ? config.max_size : 1])
+    {
+    }
+
+    connection_pool(const connection_pool&) = delete;
+    connection_pool(connection_pool&&) = delete;
+    connection_pool& operator=(const connection_pool&) = delete;
+    connection_pool& operator=(connection_pool&&) = delete;
+    ~connection_pool() = default;  // all leases must have been returned
+
+    std::size_t max_size() const
+    {
+      return _config.max_size ? _config.max_size : 1;
+    }
+
+    lease_t acquire()
+    {
+      if (auto slot = _try_acquire())
+        return {*this, *slot};
+
+      ++_waits;
+      const auto start = _clock_t::now();
+      const auto deadline = start + _config.wait_timeout;
+      while (true)
+      {
+        {
+          std::unique_lock<std::mutex> lock(_wait_mutex);
+          ++_waiting;
+          const auto available = _returned.wait_until(lock, deadline, [this] { return _has_available(); });
+          --_waiting;
+          if (not available)
+          {
+            ++_timeouts;
+            _add_wait_time(start);
+            throw sqlpp::exception("connection pool: timeout while waiting for a connection");
+          }
+        }
+        // Another thread might be faster, then we wait again
+        if (auto slot = _try_acquire())
+        {
+          _add_wait_time(start);
+          return {*this, *slot};
+        }
+      }
+    }
+
+    connection_pool_metrics_t metrics() const
+    {
+      return {_leases_in_use.load(),
+              _total_leases.load(),
+              _waits.load(),
+              _timeouts.load(),
+              std::chrono::microseconds(_wait_time_us.load()),
+              _connections_created.load(),
+              _connections_dropped.load(),
+              _validation_failures.load()};
+    }
+
+  private:
+    std::size_t _preferred_slot() const
+    {
+      return std::hash<std::thread::id>()(std::this_thread::get_id()) % max_size();
+    }
+
+    bool _has_available() const
+    {
+      for (std::size_t i = 0; i < max_size(); ++i)
+      {
+        if (_slots[i]._state.load() != slot_leased)
+          return true;
+      }
+      return false;
+    }
+
+    _slot_t* _try_acquire()
+    {
+      const auto size = max_size();
+      const auto preferred = _preferred_slot();
+
+      // Idle connections first
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        auto& slot = _slots[(preferred + i) % size];
+        int expected = slot_idle;
+        if (slot._state.compare_exchange_strong(expected, slot_leased, std::memory_order_acquire))
+        {
+          _prepare_idle(slot);
+          return _leased(slot);
+        }
+      }
+
+      // Then open a new connection
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        auto& slot = _slots[(preferred + i) % size];
+        int expected = slot_empty;
+        if (slot._state.compare_exchange_strong(expected, slot_leased, std::memory_order_acquire))
+        {
+          _connect(slot);
+          return _leased(slot);
+        }
+      }
+      return nullptr;
+    }
+
+    _slot_t* _leased(_slot_t& slot)
+    {
+      ++_leases_in_use;
+      ++_total_leases;
+      return &slot;
+    }
+
+    void _connect(_slot_t& slot)
+    {
+      try
+      {
+        slot._connection = _factory();
+        ++_connections_created;
+      }
+      catch (...)
+      {
+        slot._state.store(slot_empty);  // sequentially consistent, see _notify()
+        _notify();
+        throw;
+      }
+    }
+
+    void _prepare_idle(_slot_t& slot)
+    {
+      if (_validator and _clock_t::now() - slot._last_used >= _config.validate_after)
+      {
+        bool valid = false;
+        try
+        {
+          valid = _validator(*slot._connection);
+        }
+        catch (...)
+        {
+        }
+        if (not valid)
+        {
+          ++_validation_failures;
+          _drop(slot);
+          _connect(slot);
+        }
+      }
+    }
+
+    void _drop(_slot_t& slot)
+    {
+      slot._prepared_statements.clear();
+      slot._connection.reset();
+      ++_connections_dropped;
+    }
+
+    void _return(_slot_t& slot)
+    {
+      slot._last_used = _clock_t::now();
+      --_leases_in_use;
+      slot._state.store(slot._connection ? slot_idle : slot_empty);  // sequentially consistent, see _notify()
+      _notify();
+    }
+
+    // Waiters increment _waiting before checking the slot states, returning threads store the slot state before
+    // checking _waiting. With sequentially consistent operations on both sides, at least one of them sees the
+    // other's write, so a waiter cannot miss the wakeup for a returned connection.
+    void _notify()
+    {
+      if (_waiting.load(std::memory_order_seq_cst))
+      {
+        std::lock_guard<std::mutex> lock(_wait_mutex);
+        _returned.notify_one();
+      }
+    }
+
+    void _add_wait_time(_clock_t::time_point start)
+    {
+      _wait_time_us += static_cast<std::size_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(_clock_t::now() - start).count());
+    }
+  };
+}
+
+#endif
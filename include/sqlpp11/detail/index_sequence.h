@@ -40,23 +40,37 @@ namespace sqlpp
     {
     };
 
-    template <typename T, std::size_t N>
-    struct make_index_sequence_impl;
+    template <typename Lhs, typename Rhs>
+    struct concat_index_sequence;
 
-    template <std::size_t N, std::size_t... Ints>
-    struct make_index_sequence_impl<index_sequence<Ints...>, N>
+    template <std::size_t... Lhs, std::size_t... Rhs>
+    struct concat_index_sequence<index_sequence<Lhs...>, index_sequence<Rhs...>>
     {
-      using type = typename make_index_sequence_impl<index_sequence<Ints..., sizeof...(Ints)>, N - 1>::type;
+      using type = index_sequence<Lhs..., (sizeof...(Lhs) + Rhs)...>;
     };
 
-    template <std::size_t... Ints>
-    struct make_index_sequence_impl<index_sequence<Ints...>, 0>
+    // Logarithmic recursion depth
+    template <std::size_t N>
+    struct make_index_sequence_impl
+    {
+      using type = typename concat_index_sequence<typename make_index_sequence_impl<N / 2>::type,
+                                                  typename make_index_sequence_impl<N - N / 2>::type>::type;
+    };
+
+    template <>
+    struct make_index_sequence_impl<0>
+    {
+      using type = index_sequence<>;
+    };
+
+    template <>
+    struct make_index_sequence_impl<1>
     {
-      using type = index_sequence<Ints...>;
+      using type = index_sequence<0>;
     };
 
     template <std::size_t N>
-    using make_index_sequence = typename make_index_sequence_impl<index_sequence<>, N>::type;
+    using make_index_sequence = typename make_index_sequence_impl<N>::type;
   }
 }
 
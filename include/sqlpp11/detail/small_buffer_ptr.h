@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_DETAIL_SMALL_BUFFER_PTR_H
+#define SQLPP_DETAIL_SMALL_BUFFER_PTR_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sqlpp
+{
+  namespace detail
+  {
+    // Owns a polymorphic object derived from Base with value semantics.
+    // Objects of up to Capacity bytes are stored inline, larger ones on the heap.
+    // There is no reference counting: Copying clones the object, moving an inline object moves it.
+    template <typename Base, std::size_t Capacity>
+    class small_buffer_ptr
+    {
+      using _storage_t = typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type;
+
+      struct _ops_t
+      {
+        bool _is_inline;
+        Base* (*_copy)(const Base&, _storage_t&);
+        Base* (*_move)(Base&, _storage_t&);
+        void (*_destroy)(Base*);
+      };
+
+      template <typename T>
+      struct _fits_inline
+          : std::integral_constant<bool,
+                                   sizeof(T) <= sizeof(_storage_t) and alignof(T) <= alignof(_storage_t) and
+                                       std::is_nothrow_move_constructible<T>::value>
+      {
+      };
+
+      template <typename T, typename... Args>
+      static Base* _construct(std::true_type /* inline */, _storage_t& storage, Args&&... args)
+      {
+        return new (&storage) T(std::forward<Args>(args)...);
+      }
+
+      template <typename T, typename... Args>
+      static Base* _construct(std::false_type /* inline */, _storage_t&, Args&&... args)
+      {
+        return new T(std::forward<Args>(args)...);
+      }
+
+      template <typename T>
+      static Base* _copy(const Base& base, _storage_t& storage)
+      {
+        return _construct<T>(_fits_inline<T>{}, storage, static_cast<const T&>(base));
+      }
+
+      template <typename T>
+      static Base* _move(Base& base, _storage_t& storage)
+      {
+        // only used for inline objects, heap objects are handed over as a whole
+        return _construct<T>(std::true_type{}, storage, std::move(static_cast<T&>(base)));
+      }
+
+      template <typename T>
+      static void _destroy(std::true_type /* inline */, Base* base)
+      {
+        static_cast<T*>(base)->~T();
+      }
+
+      template <typename T>
+      static void _destroy(std::false_type /* inline */, Base* base)
+      {
+        delete static_cast<T*>(base);
+      }
+
+      template <typename T>
+      static void _destroy(Base* base)
+      {
+        _destroy<T>(_fits_inline<T>{}, base);
+      }
+
+      template <typename T>
+      static const _ops_t* _ops_of()
+      {
+        static const _ops_t ops = {_fits_inline<T>::value, &_copy<T>, &_move<T>, &_destroy<T>};
+        return &ops;
+      }
+
+      const _ops_t* _ops = nullptr;
+      Base* _ptr = nullptr;
+      _storage_t _storage;
+
+      void _copy_from(const small_buffer_ptr& rhs)
+      {
+        if (rhs._ptr)
+        {
+          _ptr = rhs._ops->_copy(*rhs._ptr, _storage);
+          _ops = rhs._ops;
+        }
+      }
+
+      void _move_from(small_buffer_ptr& rhs) noexcept
+      {
+        if (rhs._ptr)
+        {
+          _ops = rhs._ops;
+          if (_ops->_is_inline)
+          {
+            _ptr = _ops->_move(*rhs._ptr, _storage);
+          }
+          else
+          {
+            _ptr = rhs._ptr;
+            rhs._ptr = nullptr;
+          }
+        }
+      }
+
+    public:
+      small_buffer_ptr() = default;
+
+      small_buffer_ptr(const small_buffer_ptr& rhs)
+      {
+        _copy_from(rhs);
+      }
+
+      small_buffer_ptr(small_buffer_ptr&& rhs) noexcept
+      {
+        _move_from(rhs);
+      }
+
+      small_buffer_ptr& operator=(const small_buffer_ptr& rhs)
+      {
+        if (this != &rhs)
+        {
+          reset();
+          _copy_from(rhs);
+        }
+        return *this;
+      }
+
+      small_buffer_ptr& operator=(small_buffer_ptr&& rhs) noexcept
+      {
+        if (this != &rhs)
+        {
+          reset();
+          _move_from(rhs);
+        }
+        return *this;
+      }
+
+      ~small_buffer_ptr()
+      {
+        reset();
+      }
+
+      template <typename T, typename... Args>
+      static small_buffer_ptr make(Args&&... args)
+      {
+        static_assert(std::is_base_of<Base, T>::value, "small_buffer_ptr can only hold objects derived from Base");
+        small_buffer_ptr result;
+        result._ptr = _construct<T>(_fits_inline<T>{}, result._storage, std::forward<Args>(args)...);
+        result._ops = _ops_of<T>();
+        return result;
+      }
+
+      void reset() noexcept
+      {
+        if (_ptr)
+        {
+          _ops->_destroy(_ptr);
+          _ptr = nullptr;
+        }
+      }
+
+      bool is_inline() const
+      {
+        return _ptr and _ops->_is_inline;
+      }
+
+      explicit operator bool() const
+      {
+        return _ptr != nullptr;
+      }
+
+      const Base& operator*() const
+      {
+        return *_ptr;
+      }
+
+      const Base* operator->() const
+      {
+        return _ptr;
+      }
+    };
+  }
+}
+
+#endif
@@ -27,9 +27,14 @@
 #ifndef SQLPP_DETAIL_TYPE_SET_H
 #define SQLPP_DETAIL_TYPE_SET_H
 
+#include <cstddef>
 #include <type_traits>
+#include <utility>
 #include <sqlpp11/wrong.h>
 #include <sqlpp11/logic.h>
+#include <sqlpp11/detail/index_sequence.h>
+#include <sqlpp11/detail/type_vector.h>
+#include <sqlpp11/detail/void.h>
 
 namespace sqlpp
 {
@@ -45,16 +50,21 @@ namespace sqlpp
     template <typename E, typename SET>
     struct is_element_of;
 
+    template <typename T>
+    struct type_set_element
+    {
+    };
+
     // A type set
+    // Membership is checked by looking up a base class, which the compiler does without instantiating anything
+    // per element. Elements must be unique (duplicates are rejected as duplicate base classes), use
+    // make_type_set to construct a type set from arbitrary types.
     template <typename... Elements>
-    struct type_set
+    struct type_set : type_set_element<Elements>...
     {
       using size = std::integral_constant<size_t, sizeof...(Elements)>;
       using _is_type_set = std::true_type;
 
-      static_assert(std::is_same<type_set, make_type_set_t<Elements...>>::value,
-                    "use make_type_set to construct a typeset");
-
       template <typename T>
       struct insert
       {
@@ -80,9 +90,95 @@ namespace sqlpp
     template <typename E, typename... Elements>
     struct is_element_of<E, type_set<Elements...>>
     {
-      static constexpr bool value = ::sqlpp::logic::any_t<std::is_same<E, Elements>::value...>::value;
+      static constexpr bool value = std::is_base_of<type_set_element<E>, type_set<Elements...>>::value;
+    };
+
+    // Non-recursive filtering: The kept elements are looked up by index (again via base classes), the indexes are
+    // computed by constexpr functions with logarithmic recursion depth.
+    template <bool... B>
+    struct bool_pack
+    {
+    };
+
+    constexpr std::size_t count_true(const bool* values, std::size_t begin, std::size_t end)
+    {
+      return end - begin == 0 ? 0 : end - begin == 1 ? (values[begin] ? 1 : 0)
+                                                     : count_true(values, begin, begin + (end - begin) / 2) +
+                                                           count_true(values, begin + (end - begin) / 2, end);
+    }
+
+    // The index of the nth (starting with 0) true value within [begin, end)
+    constexpr std::size_t nth_true(const bool* values, std::size_t n, std::size_t begin, std::size_t end)
+    {
+      return end - begin == 1
+                 ? begin
+                 : n < count_true(values, begin, begin + (end - begin) / 2)
+                       ? nth_true(values, n, begin, begin + (end - begin) / 2)
+                       : nth_true(values,
+                                  n - count_true(values, begin, begin + (end - begin) / 2),
+                                  begin + (end - begin) / 2,
+                                  end);
+    }
+
+    template <std::size_t Index, typename T>
+    struct indexed_type : type_set_element<T>
+    {
+      using type = T;
+    };
+
+    template <typename Indexes, typename... T>
+    struct indexed_types;
+
+    template <std::size_t... Indexes, typename... T>
+    struct indexed_types<index_sequence<Indexes...>, T...> : indexed_type<Indexes, T>...
+    {
     };
 
+    // Declaration only, used in unevaluated contexts
+    template <std::size_t Index, typename T>
+    indexed_type<Index, T> select_indexed_type(const indexed_type<Index, T>&);
+
+    template <typename Keep, typename Types>
+    struct filtered_types;
+
+    template <bool... Keep, typename... T>
+    struct filtered_types<bool_pack<Keep...>, type_vector<T...>>
+    {
+      static constexpr bool _keep[] = {Keep..., false};
+      using _indexed_t = indexed_types<make_index_sequence<sizeof...(T)>, T...>;
+
+      template <typename Indexes>
+      struct _select;
+
+      template <std::size_t... Indexes>
+      struct _select<index_sequence<Indexes...>>
+      {
+        using type = type_set<typename decltype(select_indexed_type<nth_true(_keep, Indexes, 0, sizeof...(T))>(
+            std::declval<const _indexed_t&>()))::type...>;
+      };
+
+      using type = typename _select<make_index_sequence<count_true(_keep, 0, sizeof...(T))>>::type;
+    };
+
+    template <bool... Keep, typename... T>
+    constexpr bool filtered_types<bool_pack<Keep...>, type_vector<T...>>::_keep[];
+
+    // The elements of a type set that fulfill the predicate
+    template <template <typename> class Predicate, typename Set>
+    struct filter_set
+    {
+      static_assert(wrong_t<filter_set>::value, "invalid argument for filter_set");
+    };
+
+    template <template <typename> class Predicate, typename... E>
+    struct filter_set<Predicate, type_set<E...>>
+    {
+      using type = typename filtered_types<bool_pack<Predicate<E>::value...>, type_vector<E...>>::type;
+    };
+
+    template <template <typename> class Predicate, typename Set>
+    using filter_set_t = typename filter_set<Predicate, Set>::type;
+
     template <typename L, typename R>
     struct joined_set
     {
@@ -92,7 +188,25 @@ namespace sqlpp
     template <typename... LElements, typename... RElements>
     struct joined_set<type_set<LElements...>, type_set<RElements...>>
     {
-      using type = make_type_set_t<LElements..., RElements...>;
+      template <typename E>
+      using _is_new = std::integral_constant<bool, not is_element_of<E, type_set<LElements...>>::value>;
+
+      template <typename Rest>
+      struct _append;
+
+      template <typename... Rest>
+      struct _append<type_set<Rest...>>
+      {
+        using type = type_set<LElements..., Rest...>;
+      };
+
+      using type = typename _append<filter_set_t<_is_new, type_set<RElements...>>>::type;
+    };
+
+    template <typename... LElements>
+    struct joined_set<type_set<LElements...>, type_set<>>
+    {
+      using type = type_set<LElements...>;
     };
 
     template <typename L, typename R>
@@ -108,7 +222,7 @@ namespace sqlpp
     struct is_superset_of<type_set<LElements...>, type_set<RElements...>>
     {
       static constexpr bool value =
-          joined_set_t<type_set<LElements...>, type_set<RElements...>>::size::value == sizeof...(LElements);
+          ::sqlpp::logic::all_t<is_element_of<RElements, type_set<LElements...>>::value...>::value;
     };
 
     template <typename L, typename R>
@@ -126,35 +240,73 @@ namespace sqlpp
     template <typename... LElements, typename... RElements>
     struct is_disjunct_from<type_set<LElements...>, type_set<RElements...>>
     {
-      static constexpr bool value = joined_set_t<type_set<LElements...>, type_set<RElements...>>::size::value ==
-                                    sizeof...(LElements) + sizeof...(RElements);
+      static constexpr bool value =
+          ::sqlpp::logic::none_t<is_element_of<RElements, type_set<LElements...>>::value...>::value;
     };
 
-    template <>
-    struct make_type_set<>
+    // True if Derived has exactly one Base subobject
+    template <typename Base, typename Derived, typename Enable = void>
+    struct is_unambiguous_base : std::false_type
     {
-      using type = type_set<>;
     };
 
-    template <typename T, typename... Rest>
-    struct make_type_set<T, Rest...>
+    template <typename Base, typename Derived>
+    struct is_unambiguous_base<Base,
+                               Derived,
+                               void_t<decltype(static_cast<const Base*>(std::declval<const Derived*>()))>>
+        : std::true_type
     {
-      using type = typename make_type_set<Rest...>::type::template insert<T>::type;
     };
 
-    template <template <typename> class Predicate, typename... T>
-    struct make_type_set_if;
+    template <bool IsUnique, typename Indexed, std::size_t Index, typename T, typename Earlier>
+    struct is_first_occurrence_impl : std::true_type
+    {
+    };
+
+    // Only duplicates have to be compared to the earlier types
+    template <typename Indexed, std::size_t Index, typename T, std::size_t... Earlier>
+    struct is_first_occurrence_impl<false, Indexed, Index, T, index_sequence<Earlier...>>
+        : ::sqlpp::logic::none_t<std::is_same<
+              T,
+              typename decltype(select_indexed_type<Earlier>(std::declval<const Indexed&>()))::type>::value...>
+    {
+    };
+
+    template <typename Indexed, std::size_t Index, typename T>
+    using is_first_occurrence = is_first_occurrence_impl<is_unambiguous_base<type_set_element<T>, Indexed>::value,
+                                                         Indexed,
+                                                         Index,
+                                                         T,
+                                                         make_index_sequence<Index>>;
+
+    template <typename Indexes, typename... T>
+    struct make_type_set_impl;
+
+    template <std::size_t... Indexes, typename... T>
+    struct make_type_set_impl<index_sequence<Indexes...>, T...>
+    {
+      using _indexed_t = indexed_types<index_sequence<Indexes...>, T...>;
+      using type = typename filtered_types<bool_pack<is_first_occurrence<_indexed_t, Indexes, T>::value...>,
+                                           type_vector<T...>>::type;
+    };
+
+    // Removes duplicates (keeping the first occurrence) without recursion
+    template <typename... T>
+    struct make_type_set
+    {
+      using type = typename make_type_set_impl<make_index_sequence<sizeof...(T)>, T...>::type;
+    };
 
-    template <template <typename> class Predicate>
-    struct make_type_set_if<Predicate>
+    template <>
+    struct make_type_set<>
     {
       using type = type_set<>;
     };
 
-    template <template <typename> class Predicate, typename T, typename... Rest>
-    struct make_type_set_if<Predicate, T, Rest...>
+    template <template <typename> class Predicate, typename... T>
+    struct make_type_set_if
     {
-      using type = typename make_type_set_if<Predicate, Rest...>::type::template insert_if<Predicate, T>::type;
+      using type = filter_set_t<Predicate, make_type_set_t<T...>>;
     };
 
     template <template <typename> class Predicate, typename... T>
@@ -207,8 +359,8 @@ namespace sqlpp
     struct make_difference_set<type_set<Minuends...>, type_set<Subtrahends...>>
     {
       template <typename E>
-      using is_subtrahend = is_element_of<E, type_set<Subtrahends...>>;
-      using type = make_type_set_if_not_t<is_subtrahend, Minuends...>;
+      using is_not_subtrahend = std::integral_constant<bool, not is_element_of<E, type_set<Subtrahends...>>::value>;
+      using type = filter_set_t<is_not_subtrahend, type_set<Minuends...>>;
     };
 
     template <typename Minuend, typename Subtrahend>
@@ -224,9 +376,8 @@ namespace sqlpp
     struct make_intersect_set<type_set<LhsElements...>, type_set<RhsElements...>>
     {
       template <typename E>
-      using is_in_both = ::sqlpp::logic::all_t<is_element_of<E, type_set<LhsElements...>>::value,
-                                               is_element_of<E, type_set<RhsElements...>>::value>;
-      using type = make_type_set_if_t<is_in_both, LhsElements...>;
+      using is_in_rhs = is_element_of<E, type_set<RhsElements...>>;
+      using type = filter_set_t<is_in_rhs, type_set<LhsElements...>>;
     };
 
     template <typename Lhs, typename Rhs>
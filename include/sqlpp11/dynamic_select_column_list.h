@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <string>
+#include <sqlpp11/arena.h>
 #include <sqlpp11/no_name.h>
 #include <sqlpp11/named_interpretable.h>
 
@@ -37,8 +38,9 @@ namespace sqlpp
   template <typename Db>
   struct dynamic_select_column_list
   {
-    using _names_t = std::vector<std::string>;
-    std::vector<named_interpretable_t<Db>> _dynamic_columns;
+    // The vector uses the arena, the names themselves are std::strings, see with_arena()
+    using _names_t = std::vector<std::string, arena_allocator<std::string>>;
+    std::vector<named_interpretable_t<Db>, arena_allocator<named_interpretable_t<Db>>> _dynamic_columns;
     _names_t _dynamic_expression_names;
 
     template <typename Expr>
@@ -57,6 +59,18 @@ namespace sqlpp
     {
       return _dynamic_columns.size();
     }
+
+    void clear()
+    {
+      _dynamic_expression_names.clear();
+      _dynamic_columns.clear();
+    }
+
+    void _use_arena(arena_t* arena)
+    {
+      detail::move_to_arena(_dynamic_expression_names, arena);
+      detail::move_to_arena(_dynamic_columns, arena);
+    }
   };
 
   template <>
@@ -74,6 +88,10 @@ namespace sqlpp
     {
       return {};
     }
+
+    void _use_arena(arena_t*)
+    {
+    }
   };
 
   template <typename Context, typename Db>
@@ -84,7 +102,7 @@ namespace sqlpp
     static Context& _(const T& t, Context& context)
     {
       bool first = true;
-      for (const auto column : t._dynamic_columns)
+      for (const auto& column : t._dynamic_columns)
       {
         if (first)
           first = false;
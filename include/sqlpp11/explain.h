@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SQLPP_EXPLAIN_H
+#define SQLPP_EXPLAIN_H
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <sqlpp11/serialize.h>
+#include <sqlpp11/detail/void.h>
+
+namespace sqlpp
+{
+  // One entry per row of the query plan, columns separated by the connector (e.g. by '|')
+  using explain_plan_t = std::vector<std::string>;
+
+  // A bound value of a prepared statement: The raw value as text (e.g. 7, O'Brien or 2016-11-03), not quoted or
+  // escaped
+  struct bound_value_t
+  {
+    std::string text;
+    bool is_null = false;
+    // Text values are quoted when printed, see slow_query_recorder_t::to_text()
+    bool is_text = false;
+  };
+
+  inline bool operator==(const bound_value_t& lhs, const bound_value_t& rhs)
+  {
+    return lhs.text == rhs.text and lhs.is_null == rhs.is_null and lhs.is_text == rhs.is_text;
+  }
+
+  inline bool operator!=(const bound_value_t& lhs, const bound_value_t& rhs)
+  {
+    return not(lhs == rhs);
+  }
+
+  using bound_values_t = std::vector<bound_value_t>;
+
+  // Connector hooks:
+  //   explain_plan_t explain(const std::string& sql);  // runs sql (including the prefix) and returns the plan rows
+  //   std::string explain_prefix();                     // optional, defaults to "EXPLAIN ",
+  //                                                     // e.g. "EXPLAIN QUERY PLAN " for sqlite3
+  //   explain_plan_t explain_prepared(const std::string& sql, const bound_values_t& parameters);
+  //       // optional, prepares sql (including the prefix, with placeholders), binds the parameters (their raw text,
+  //       // or null) and returns the plan rows
+  template <typename Db, typename Enable = void>
+  struct has_explain_t : std::false_type
+  {
+  };
+
+  template <typename Db>
+  struct has_explain_t<Db, detail::void_t<decltype(std::declval<Db&>().explain(std::declval<const std::string&>()))>>
+      : std::true_type
+  {
+  };
+
+  template <typename Db, typename Enable = void>
+  struct has_explain_prepared_t : std::false_type
+  {
+  };
+
+  template <typename Db>
+  struct has_explain_prepared_t<
+      Db,
+      detail::void_t<decltype(std::declval<Db&>().explain_prepared(std::declval<const std::string&>(),
+                                                                   std::declval<const bound_values_t&>()))>>
+      : std::true_type
+  {
+  };
+
+  namespace detail
+  {
+    template <typename Db, typename Enable = void>
+    struct has_explain_prefix : std::false_type
+    {
+    };
+
+    template <typename Db>
+    struct has_explain_prefix<Db, void_t<decltype(std::declval<Db&>().explain_prefix())>> : std::true_type
+    {
+    };
+
+    template <typename Db>
+    std::string explain_prefix(Db& db, std::true_type)
+    {
+      return db.explain_prefix();
+    }
+
+    template <typename Db>
+    std::string explain_prefix(Db&, std::false_type)
+    {
+      return "EXPLAIN ";
+    }
+  }
+
+  // The plan of an already serialized statement
+  template <typename Db>
+  explain_plan_t explain_sql(Db& db, const std::string& sql)
+  {
+    static_assert(has_explain_t<Db>::value, "connector does not support explain");
+    return db.explain(detail::explain_prefix(db, detail::has_explain_prefix<Db>{}) + sql);
+  }
+
+  // The plan of a statement with placeholders, using the given parameter values, see slow_query_t::parameters
+  template <typename Db>
+  explain_plan_t explain_prepared_sql(Db& db, const std::string& sql, const bound_values_t& parameters)
+  {
+    static_assert(has_explain_prepared_t<Db>::value, "connector does not support explaining prepared statements");
+    return db.explain_prepared(detail::explain_prefix(db, detail::has_explain_prefix<Db>{}) + sql, parameters);
+  }
+
+  // Parameters are serialized as placeholders, not every database can explain those
+  template <typename Db, typename Statement>
+  explain_plan_t explain(Db& db, const Statement& statement)
+  {
+    auto context = db.get_serializer_context();
+    serialize(statement, context);
+    return explain_sql(db, context.str());
+  }
+}
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_FINGERPRINT_H
+#define SQLPP_FINGERPRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <sqlpp11/serialize.h>
+
+namespace sqlpp
+{
+  namespace detail
+  {
+    template <typename T>
+    struct type_id_holder
+    {
+      static const char _id;
+    };
+
+    template <typename T>
+    const char type_id_holder<T>::_id = 0;
+
+    // Unique per type within the process, no RTTI required
+    template <typename T>
+    std::size_t type_id()
+    {
+      return reinterpret_cast<std::uintptr_t>(&type_id_holder<T>::_id);
+    }
+
+    // The golden ratio in the width of size_t
+    static constexpr std::size_t hash_golden_ratio =
+        sizeof(std::size_t) > 4 ? static_cast<std::size_t>(0x9e3779b97f4a7c15ull) : 0x9e3779b9ul;
+
+    inline std::size_t hash_combine(std::size_t seed, std::size_t value)
+    {
+      return seed ^ (value + hash_golden_ratio + (seed << 6) + (seed >> 2));
+    }
+
+    // Returned by fingerprint_context_t::escape() to mark text values, which are ignored like other values
+    struct fingerprint_value_t
+    {
+    };
+  }
+
+  // Serializer context that records the shape of a statement instead of its text:
+  // Keywords, names and separators are hashed by address, other text (e.g. verbatim SQL) by content.
+  // Values (numbers, dates, escaped text) are ignored.
+  struct fingerprint_context_t
+  {
+    std::size_t _hash;
+
+    fingerprint_context_t(std::size_t seed = 0) : _hash(seed)
+    {
+    }
+
+    fingerprint_context_t& operator<<(const char* static_text)
+    {
+      _hash = detail::hash_combine(_hash, reinterpret_cast<std::uintptr_t>(static_text));
+      return *this;
+    }
+
+    fingerprint_context_t& operator<<(char c)
+    {
+      _hash = detail::hash_combine(_hash, static_cast<unsigned char>(c));
+      return *this;
+    }
+
+    fingerprint_context_t& operator<<(const std::string& text)
+    {
+      _hash = detail::hash_combine(_hash, std::hash<std::string>{}(text));
+      return *this;
+    }
+
+    template <typename T>
+    fingerprint_context_t& operator<<(const T&)
+    {
+      return *this;
+    }
+
+    template <typename T>
+    static detail::fingerprint_value_t escape(const T&)
+    {
+      return {};
+    }
+
+    template <typename T>
+    void add_type()
+    {
+      _hash = detail::hash_combine(_hash, detail::type_id<T>());
+    }
+  };
+
+  // A cheap hash of the shape of a statement:
+  // Two statements of the same type with the same sequence of dynamic parts (columns, conditions, joins,
+  // assignments, verbatim text, etc) have the same fingerprint, even if they differ in literal values.
+  // Literal values are ignored, e.g. where(t.alpha == 7) and where(t.alpha == 8) have the same fingerprint.
+  // A cache of prepared (or serialized) statements keyed by the fingerprint is therefore only correct if every
+  // value in the cached statements is a parameter(). Otherwise it silently returns the statement of another value.
+  // Fingerprints are stable within a process only.
+  template <typename T>
+  std::size_t fingerprint(const T& t)
+  {
+    fingerprint_context_t context;
+    context.add_type<T>();
+    serialize(t, context);
+    return context._hash;
+  }
+}
+
+#endif
@@ -55,6 +55,11 @@ namespace sqlpp
 
     Table _table;
     interpretable_list_t<Database> _dynamic_tables;
+
+    void _use_arena(arena_t* arena)
+    {
+      _dynamic_tables._use_arena(arena);
+    }
   };
 
   SQLPP_PORTABLE_STATIC_ASSERT(assert_from_add_dynamic, "from::add() requires a dynamic_from");
@@ -123,6 +128,13 @@ namespace sqlpp
         return _add_impl(dynamicJoin, Check{});
       }
 
+      // Removes the dynamic parts, but keeps the allocated capacity for re-use
+      void clear()
+      {
+        static_assert(_is_dynamic::value, "from::clear() can only be called for dynamic_from");
+        _data._dynamic_tables.clear();
+      }
+
     private:
       template <typename DynamicJoin>
       auto _add_impl(DynamicJoin dynamicJoin, consistent_t) -> void
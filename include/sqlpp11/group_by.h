@@ -53,6 +53,11 @@ namespace sqlpp
 
     std::tuple<Expressions...> _expressions;
     interpretable_list_t<Database> _dynamic_expressions;
+
+    void _use_arena(arena_t* arena)
+    {
+      _dynamic_expressions._use_arena(arena);
+    }
   };
 
   SQLPP_PORTABLE_STATIC_ASSERT(
@@ -98,6 +103,13 @@ namespace sqlpp
         _add_impl(expression, ok());  // dispatch to prevent compile messages after the static_assert
       }
 
+      // Removes the dynamic parts, but keeps the allocated capacity for re-use
+      void clear()
+      {
+        static_assert(_is_dynamic::value, "group_by::clear() can only be called for dynamic_group_by");
+        _data._dynamic_expressions.clear();
+      }
+
     private:
       template <typename Expression>
       void _add_impl(Expression expression, const std::true_type&)
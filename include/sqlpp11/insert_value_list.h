@@ -27,6 +27,7 @@
 #ifndef SQLPP_INSERT_VALUE_LIST_H
 #define SQLPP_INSERT_VALUE_LIST_H
 
+#include <sqlpp11/arena.h>
 #include <sqlpp11/assignment.h>
 #include <sqlpp11/column_fwd.h>
 #include <sqlpp11/expression_fwd.h>
@@ -140,6 +141,12 @@ namespace sqlpp
     std::tuple<rhs_t<Assignments>...> _values;
     interpretable_list_t<Database> _dynamic_columns;
     interpretable_list_t<Database> _dynamic_values;
+
+    void _use_arena(arena_t* arena)
+    {
+      _dynamic_columns._use_arena(arena);
+      _dynamic_values._use_arena(arena);
+    }
   };
 
   SQLPP_PORTABLE_STATIC_ASSERT(assert_insert_set_assignments_t, "at least one argument is not an assignment in set()");
@@ -270,6 +277,14 @@ namespace sqlpp
         _add_impl(assignment, ok());  // dispatch to prevent compile messages after the static_assert
       }
 
+      // Removes the dynamic assignments, but keeps the allocated capacity for re-use
+      void clear()
+      {
+        static_assert(_is_dynamic::value, "insert_list::clear() can only be called for dynamic_set");
+        _data._dynamic_columns.clear();
+        _data._dynamic_values.clear();
+      }
+
     private:
       template <typename Assignment>
       void _add_impl(Assignment assignment, const std::true_type&)
@@ -335,7 +350,12 @@ namespace sqlpp
 
     using _value_tuple_t = std::tuple<insert_value_t<Columns>...>;
     std::tuple<simple_column_t<Columns>...> _columns;
-    std::vector<_value_tuple_t> _insert_values;
+    std::vector<_value_tuple_t, arena_allocator<_value_tuple_t>> _insert_values;
+
+    void _use_arena(arena_t* arena)
+    {
+      detail::move_to_arena(_insert_values, arena);
+    }
   };
 
   SQLPP_PORTABLE_STATIC_ASSERT(assert_no_unknown_tables_in_column_list_t,
@@ -376,6 +396,12 @@ namespace sqlpp
         _add_impl(ok(), assignments...);  // dispatch to prevent compile messages after the static_assert
       }
 
+      // Removes the rows added so far, but keeps the allocated capacity for re-use
+      void clear()
+      {
+        _data._insert_values.clear();
+      }
+
     private:
       template <typename... Assignments>
       void _add_impl(const std::true_type&, Assignments... assignments)
@@ -0,0 +1,869 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_INSTRUMENTED_H
+#define SQLPP_INSTRUMENTED_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <sqlpp11/connection.h>
+#include <sqlpp11/explain.h>
+#include <sqlpp11/fingerprint.h>
+#include <sqlpp11/result.h>
+#include <sqlpp11/serialize.h>
+#include <sqlpp11/slow_query_recorder.h>
+#include <sqlpp11/statement_shape.h>
+#include <sqlpp11/transaction.h>
+#include <sqlpp11/type_traits.h>
+
+namespace sqlpp
+{
+  enum class instrumented_call
+  {
+    select,
+    insert,
+    update,
+    remove,
+    execute,
+    prepare_select,
+    prepare_insert,
+    prepare_update,
+    prepare_remove,
+    prepare_execute,
+    run_prepared_select,
+    run_prepared_insert,
+    run_prepared_update,
+    run_prepared_remove,
+    run_prepared_execute,
+    start_transaction,
+    commit_transaction,
+    rollback_transaction
+  };
+
+  inline const char* to_string(instrumented_call call)
+  {
+    switch (call)
+    {
+      case instrumented_call::select:
+        return "select";
+      case instrumented_call::insert:
+        return "insert";
+      case instrumented_call::update:
+        return "update";
+      case instrumented_call::remove:
+        return "remove";
+      case instrumented_call::execute:
+        return "execute";
+      case instrumented_call::prepare_select:
+        return "prepare_select";
+      case instrumented_call::prepare_insert:
+        return "prepare_insert";
+      case instrumented_call::prepare_update:
+        return "prepare_update";
+      case instrumented_call::prepare_remove:
+        return "prepare_remove";
+      case instrumented_call::prepare_execute:
+        return "prepare_execute";
+      case instrumented_call::run_prepared_select:
+        return "run_prepared_select";
+      case instrumented_call::run_prepared_insert:
+        return "run_prepared_insert";
+      case instrumented_call::run_prepared_update:
+        return "run_prepared_update";
+      case instrumented_call::run_prepared_remove:
+        return "run_prepared_remove";
+      case instrumented_call::run_prepared_execute:
+        return "run_prepared_execute";
+      case instrumented_call::start_transaction:
+        return "start_transaction";
+      case instrumented_call::commit_transaction:
+        return "commit_transaction";
+      case instrumented_call::rollback_transaction:
+        return "rollback_transaction";
+    }
+    return "unknown";
+  }
+
+  struct execution_timing_t
+  {
+    using duration = std::chrono::nanoseconds;
+
+    execution_timing_t(instrumented_call call_ = instrumented_call::execute) : call(call_)
+    {
+    }
+
+    instrumented_call call;
+    // detail::type_id() of the statement (or prepared statement) type, zero for strings and transactions
+    std::size_t statement_id = 0;
+    // See statement_shape(), null for strings and transactions
+    const statement_shape_t* shape = nullptr;
+    std::size_t sql_bytes = 0;
+    // Serializing the statement into the connection's serializer context
+    duration serialization = duration::zero();
+    // The connector call, including the connector's own serialization
+    duration execution = duration::zero();
+    // From the start of the execution until the first row (or the end of an empty result) was fetched
+    duration first_row = duration::zero();
+    // Fetched rows for selects, affected rows for update, remove and execute (if the connector returns them).
+    // Always 0 for inserts, connectors return the last insert id instead of a row count.
+    std::size_t rows = 0;
+    bool failed = false;
+  };
+
+  // Called on the connection's thread. For selects, it is called once the result is exhausted or destroyed.
+  // Sinks should not throw: Exceptions are passed on to the caller of an otherwise successful statement, and they
+  // are dropped if the report is sent from the destructor of a result.
+  using instrumentation_sink_t = std::function<void(const execution_timing_t&)>;
+
+  namespace detail
+  {
+    using instrumentation_clock_t = std::chrono::steady_clock;
+
+    inline execution_timing_t::duration elapsed_since(instrumentation_clock_t::time_point start)
+    {
+      return std::chrono::duration_cast<execution_timing_t::duration>(instrumentation_clock_t::now() - start);
+    }
+
+    template <typename T>
+    std::size_t affected_rows(const T&)
+    {
+      return 0;
+    }
+
+    inline std::size_t affected_rows(std::size_t rows)
+    {
+      return rows;
+    }
+
+    inline bool returns_insert_id(instrumented_call call)
+    {
+      return call == instrumented_call::insert or call == instrumented_call::run_prepared_insert;
+    }
+
+    // Prepared statement handle of an instrumented connection: The connector's handle and the statement text
+    // for the slow query recorder
+    template <typename Handle, bool = std::is_class<Handle>::value>
+    struct instrumented_prepared_statement_t : public Handle
+    {
+      instrumented_prepared_statement_t(Handle handle, std::string sql)
+          : Handle(std::move(handle)), _instrumented_sql(std::move(sql))
+      {
+      }
+
+      std::string _instrumented_sql;
+    };
+
+    // E.g. handles of mock connections which do not bind parameters
+    template <typename Handle>
+    struct instrumented_prepared_statement_t<Handle, false>
+    {
+      instrumented_prepared_statement_t(Handle handle, std::string sql)
+          : _handle(std::move(handle)), _instrumented_sql(std::move(sql))
+      {
+      }
+
+      operator Handle&()
+      {
+        return _handle;
+      }
+
+      operator const Handle&() const
+      {
+        return _handle;
+      }
+
+      Handle _handle;
+      std::string _instrumented_sql;
+    };
+
+    struct instrumented_execution_t
+    {
+      instrumented_execution_t(execution_timing_t timing_) : timing(timing_)
+      {
+      }
+
+      execution_timing_t timing;
+      // Only kept for the slow query recorder
+      std::string sql;
+      // Prepared statements: The text and the parameters are only captured for slow queries. The prepared
+      // statement has to outlive the report, i.e. its results.
+      const void* prepared = nullptr;
+      void (*capture_prepared)(const void* prepared, slow_query_t& query) = nullptr;
+      // Preparing a statement does not execute it, the plan is recorded when the prepared statement is run
+      bool is_prepare = false;
+      bool is_prepared = false;
+      // Reported while the result still has pending rows, the connection cannot run another statement then
+      bool has_pending_result = false;
+    };
+
+    // Sink and slow query recorder of an instrumented connection
+    struct instrumentation_reporter_t
+    {
+      instrumentation_sink_t sink;
+      slow_query_recorder_t* recorder = nullptr;
+      std::function<explain_plan_t(const std::string&)> explain;
+      std::function<explain_plan_t(const std::string&, const bound_values_t&)> explain_prepared;
+
+      explicit operator bool() const
+      {
+        return sink or recorder;
+      }
+
+      void operator()(const instrumented_execution_t& execution) const
+      {
+        if (sink)
+          sink(execution.timing);
+        if (recorder)
+          _record(execution);
+      }
+
+    private:
+      void _record(const instrumented_execution_t& execution) const
+      {
+        const auto& timing = execution.timing;
+        const auto elapsed = timing.serialization + std::max(timing.execution, timing.first_row);
+        if (not recorder->is_slow(elapsed))
+          return;
+        slow_query_t query;
+        if (execution.capture_prepared)
+          execution.capture_prepared(execution.prepared, query);
+        else
+          query.sql = execution.sql;
+        if (query.sql.empty())
+          return;
+        query.shape = timing.shape ? timing.shape->name : std::string{};
+        query.elapsed = elapsed;
+        query.failed = timing.failed;
+        _explain(execution, query);
+        recorder->record(std::move(query));
+      }
+
+      // The query is recorded without plan if it cannot be explained
+      void _explain(const instrumented_execution_t& execution, slow_query_t& query) const
+      {
+        if (execution.is_prepare)
+          return;
+        if (execution.has_pending_result)
+        {
+          query.explain_error = "result has pending rows";
+          return;
+        }
+        if (execution.is_prepared ? not explain_prepared : not explain)
+        {
+          query.explain_error = "not supported by the connector";
+          return;
+        }
+        try
+        {
+          query.plan = execution.is_prepared ? explain_prepared(query.sql, query.parameters) : explain(query.sql);
+        }
+        catch (const std::exception& e)
+        {
+          query.explain_error = e.what();
+        }
+        catch (...)
+        {
+          query.explain_error = "unknown exception";
+        }
+      }
+    };
+  }
+
+  // Counts fetched rows and reports the timing of a select to the sink.
+  // Results of a disabled connection forward to the connector's result, checking for a reporter once per row.
+  template <typename DbResult>
+  class instrumented_result_t
+  {
+    DbResult _result;
+    const detail::instrumentation_reporter_t* _reporter = nullptr;
+    detail::instrumented_execution_t _execution{execution_timing_t{}};
+    detail::instrumentation_clock_t::time_point _start;
+    bool _has_fetched = false;
+    bool _is_exhausted = false;
+
+    void _report()
+    {
+      if (not _is_exhausted)
+        _execution.has_pending_result = true;
+      const auto reporter = _reporter;
+      _reporter = nullptr;
+      (*reporter)(_execution);
+    }
+
+  public:
+    instrumented_result_t() = default;
+
+    instrumented_result_t(DbResult result) : _result(std::move(result))
+    {
+    }
+
+    instrumented_result_t(DbResult result,
+                          const detail::instrumentation_reporter_t& reporter,
+                          detail::instrumented_execution_t execution,
+                          detail::instrumentation_clock_t::time_point start)
+        : _result(std::move(result)), _reporter(&reporter), _execution(std::move(execution)), _start(start)
+    {
+    }
+
+    instrumented_result_t(const instrumented_result_t&) = delete;
+    instrumented_result_t(instrumented_result_t&& rhs)
+        : _result(std::move(rhs._result)),
+          _reporter(rhs._reporter),
+          _execution(std::move(rhs._execution)),
+          _start(rhs._start),
+          _has_fetched(rhs._has_fetched),
+          _is_exhausted(rhs._is_exhausted)
+    {
+      rhs._reporter = nullptr;
+    }
+    instrumented_result_t& operator=(const instrumented_result_t&) = delete;
+    instrumented_result_t& operator=(instrumented_result_t&& rhs)
+    {
+      if (this != &rhs)
+      {
+        if (_reporter)
+          _report();
+        _result = std::move(rhs._result);
+        _reporter = rhs._reporter;
+        _execution = std::move(rhs._execution);
+        _start = rhs._start;
+        _has_fetched = rhs._has_fetched;
+        _is_exhausted = rhs._is_exhausted;
+        rhs._reporter = nullptr;
+      }
+      return *this;
+    }
+
+    ~instrumented_result_t()
+    {
+      if (_reporter)
+      {
+        try
+        {
+          _report();
+        }
+        catch (...)
+        {
+        }
+      }
+    }
+
+    bool operator==(const instrumented_result_t& rhs) const
+    {
+      return _result == rhs._result;
+    }
+
+    template <typename ResultRow>
+    void next(ResultRow& result_row)
+    {
+      _result.next(result_row);
+      if (not _reporter)
+        return;
+      if (not _has_fetched)
+      {
+        _execution.timing.first_row = detail::elapsed_since(_start);
+        _has_fetched = true;
+      }
+      if (result_row)
+        ++_execution.timing.rows;
+      else
+      {
+        _is_exhausted = true;
+        _report();
+      }
+    }
+  };
+
+  template <typename DbResult>
+  struct iterator_category<instrumented_result_t<DbResult>>
+  {
+    using type = typename iterator_category<DbResult>::type;
+  };
+
+  // Forwards the connection interface to the wrapped connection and reports the timing of each call to the
+  // sink. The connection is not owned and must outlive the wrapper (and the results obtained through it).
+  //
+  // Instrumentation is switched on and off at runtime (by setting a sink or a slow query recorder), which is not
+  // free:
+  //   - Enabled, each statement is serialized twice, once here to measure the serialization (and to keep the text
+  //     for the slow query recorder), and once more by the connector.
+  //   - Disabled, calls are forwarded after a branch, but the types stay the same: Results are wrapped in
+  //     instrumented_result_t (one more branch per row and an empty execution record) and prepared statement
+  //     handles carry an (empty) std::string for their text.
+  // For no cost at all, choose at compile time and use the connection itself where instrumentation is not needed.
+  template <typename Db>
+  class instrumented : public sqlpp::connection
+  {
+    using _clock_t = detail::instrumentation_clock_t;
+
+    Db& _db;
+    detail::instrumentation_reporter_t _reporter;
+
+    template <typename Statement>
+    detail::instrumented_execution_t _serialize(instrumented_call call, const Statement& s)
+    {
+      detail::instrumented_execution_t execution{execution_timing_t{call}};
+      auto& timing = execution.timing;
+      timing.statement_id = detail::type_id<Statement>();
+      timing.shape = &statement_shape<Statement>();
+      const auto start = _clock_t::now();
+      auto context = _db.get_serializer_context();
+      serialize(s, context);
+      timing.sql_bytes = context.str().size();
+      timing.serialization = detail::elapsed_since(start);
+      if (_reporter.recorder)
+        execution.sql = context.str();
+      return execution;
+    }
+
+    // Reports failed calls. Successful calls are reported by the caller, outside of the try block, so that an
+    // exception thrown by the sink is not mistaken for a failure of the call.
+    template <typename Call>
+    auto _call(detail::instrumented_execution_t& execution, _clock_t::time_point start, Call& call)
+        -> decltype(call())
+    {
+      try
+      {
+        return call();
+      }
+      catch (...)
+      {
+        execution.timing.execution = detail::elapsed_since(start);
+        execution.timing.failed = true;
+        _reporter(execution);
+        throw;
+      }
+    }
+
+    template <typename Call>
+    auto _timed(detail::instrumented_execution_t execution, Call call) -> decltype(call())
+    {
+      const auto start = _clock_t::now();
+      auto result = _call(execution, start, call);
+      execution.timing.execution = detail::elapsed_since(start);
+      if (not detail::returns_insert_id(execution.timing.call))
+        execution.timing.rows = detail::affected_rows(result);
+      _reporter(execution);
+      return result;
+    }
+
+    template <typename Call>
+    void _timed_void(detail::instrumented_execution_t execution, Call call)
+    {
+      const auto start = _clock_t::now();
+      _call(execution, start, call);
+      execution.timing.execution = detail::elapsed_since(start);
+      _reporter(execution);
+    }
+
+    template <typename Call>
+    auto _timed_select(detail::instrumented_execution_t execution, Call call)
+        -> instrumented_result_t<decltype(call())>
+    {
+      const auto start = _clock_t::now();
+      auto result = _call(execution, start, call);
+      execution.timing.execution = detail::elapsed_since(start);
+      return {std::move(result), _reporter, std::move(execution), start};
+    }
+
+    template <typename Call>
+    auto _timed_prepare(detail::instrumented_execution_t execution, Call call)
+        -> detail::instrumented_prepared_statement_t<typename Db::_prepared_statement_t>
+    {
+      auto sql = execution.sql;
+      execution.is_prepare = true;
+      return {_timed(std::move(execution), call), std::move(sql)};
+    }
+
+    template <typename Prepared>
+    detail::instrumented_execution_t _prepared_timing(instrumented_call call, const Prepared& prepared)
+    {
+      detail::instrumented_execution_t execution{execution_timing_t{call}};
+      execution.timing.statement_id = detail::type_id<Prepared>();
+      execution.timing.shape = &statement_shape<Prepared>();
+      execution.is_prepared = true;
+      if (_reporter.recorder)
+      {
+        execution.prepared = &prepared;
+        execution.capture_prepared = &_capture_prepared<Prepared>;
+      }
+      return execution;
+    }
+
+    template <typename Prepared>
+    static void _capture_prepared(const void* prepared, slow_query_t& query)
+    {
+      const auto& statement = *static_cast<const Prepared*>(prepared);
+      query.sql = statement._prepared_statement._instrumented_sql;
+      query.parameters = detail::parameter_values(statement.params);
+    }
+
+    std::function<explain_plan_t(const std::string&)> _make_explain(std::true_type)
+    {
+      return [this](const std::string& sql) { return explain_sql(_db, sql); };
+    }
+
+    std::function<explain_plan_t(const std::string&)> _make_explain(std::false_type)
+    {
+      return {};
+    }
+
+    std::function<explain_plan_t(const std::string&, const bound_values_t&)> _make_explain_prepared(
+        std::true_type)
+    {
+      return [this](const std::string& sql, const bound_values_t& parameters)
+      {
+        return explain_prepared_sql(_db, sql, parameters);
+      };
+    }
+
+    std::function<explain_plan_t(const std::string&, const bound_values_t&)> _make_explain_prepared(
+        std::false_type)
+    {
+      return {};
+    }
+
+  public:
+    using _traits = typename Db::_traits;
+    using _serializer_context_t = typename Db::_serializer_context_t;
+    using _interpreter_context_t = typename Db::_interpreter_context_t;
+    using _prepared_statement_t = detail::instrumented_prepared_statement_t<typename Db::_prepared_statement_t>;
+
+    instrumented(Db& db, instrumentation_sink_t sink = {}) : _db(db)
+    {
+      _reporter.sink = std::move(sink);
+    }
+
+    instrumented(const instrumented&) = delete;
+    instrumented(instrumented&&) = delete;
+    instrumented& operator=(const instrumented&) = delete;
+    instrumented& operator=(instrumented&&) = delete;
+    ~instrumented() = default;
+
+    template <typename T>
+    static _serializer_context_t& _serialize_interpretable(const T& t, _serializer_context_t& context)
+    {
+      return Db::_serialize_interpretable(t, context);
+    }
+
+    template <typename T>
+    static _interpreter_context_t& _interpret_interpretable(const T& t, _interpreter_context_t& context)
+    {
+      return Db::_interpret_interpretable(t, context);
+    }
+
+    Db& connection()
+    {
+      return _db;
+    }
+
+    bool enabled() const
+    {
+      return static_cast<bool>(_reporter);
+    }
+
+    // Must not be called while results obtained through the wrapper are still alive
+    void set_sink(instrumentation_sink_t sink)
+    {
+      _reporter.sink = std::move(sink);
+    }
+
+    // Statements exceeding the recorder's threshold are recorded with their text, parameters and, if the connector
+    // supports explain (explain_prepared for prepared statements), their plan. Selects are recorded once the result
+    // is exhausted or destroyed. Results destroyed with pending rows are recorded without plan, since the connection
+    // might not accept another statement before the result is freed.
+    // The text and the parameters of prepared statements are only captured once a call turned out to be slow (i.e.
+    // not within the measured time), for selects when the result is exhausted or destroyed. Prepared statements
+    // therefore have to outlive their results, and must not be re-bound while a result is still being read.
+    // The recorder is not owned (and may be shared by several connections), nullptr disables recording.
+    // Must not be called while results obtained through the wrapper are still alive
+    void set_slow_query_recorder(slow_query_recorder_t* recorder)
+    {
+      _reporter.recorder = recorder;
+      _reporter.explain = recorder ? _make_explain(has_explain_t<Db>{}) : nullptr;
+      _reporter.explain_prepared = recorder ? _make_explain_prepared(has_explain_prepared_t<Db>{}) : nullptr;
+    }
+
+    _serializer_context_t get_serializer_context()
+    {
+      return _db.get_serializer_context();
+    }
+
+    // The plan of the statement, see explain.h
+    template <
+        typename Statement,
+        typename Enable = typename std::enable_if<not std::is_convertible<Statement, std::string>::value, void>::type>
+    explain_plan_t explain(const Statement& s)
+    {
+      return sqlpp::explain(_db, s);
+    }
+
+    // Connector hooks, see explain.h
+    template <typename D = Db>
+    auto explain(const std::string& sql) -> decltype(std::declval<D&>().explain(sql))
+    {
+      return _db.explain(sql);
+    }
+
+    template <typename D = Db>
+    auto explain_prepared(const std::string& sql, const bound_values_t& parameters)
+        -> decltype(std::declval<D&>().explain_prepared(sql, parameters))
+    {
+      return _db.explain_prepared(sql, parameters);
+    }
+
+    template <typename D = Db>
+    auto explain_prefix() -> decltype(std::declval<D&>().explain_prefix())
+    {
+      return _db.explain_prefix();
+    }
+
+    // Directly executed statements start here
+    template <typename T>
+    auto _run(const T& t, ::sqlpp::consistent_t) -> decltype(t._run(*this))
+    {
+      return t._run(*this);
+    }
+
+    template <typename Check, typename T>
+    auto _run(const T& t, Check) -> Check;
+
+    template <typename T>
+    auto operator()(const T& t) -> decltype(this->_run(t, sqlpp::run_check_t<_serializer_context_t, T>{}))
+    {
+      return _run(t, sqlpp::run_check_t<_serializer_context_t, T>{});
+    }
+
+    template <typename Select, typename D = Db>
+    auto select(const Select& s) -> instrumented_result_t<decltype(std::declval<D&>().select(s))>
+    {
+      if (not _reporter)
+        return {_db.select(s)};
+      return _timed_select(_serialize(instrumented_call::select, s), [&] { return _db.select(s); });
+    }
+
+    template <typename Insert, typename D = Db>
+    auto insert(const Insert& i) -> decltype(std::declval<D&>().insert(i))
+    {
+      if (not _reporter)
+        return _db.insert(i);
+      return _timed(_serialize(instrumented_call::insert, i), [&] { return _db.insert(i); });
+    }
+
+    template <typename Update, typename D = Db>
+    auto update(const Update& u) -> decltype(std::declval<D&>().update(u))
+    {
+      if (not _reporter)
+        return _db.update(u);
+      return _timed(_serialize(instrumented_call::update, u), [&] { return _db.update(u); });
+    }
+
+    template <typename Remove, typename D = Db>
+    auto remove(const Remove& r) -> decltype(std::declval<D&>().remove(r))
+    {
+      if (not _reporter)
+        return _db.remove(r);
+      return _timed(_serialize(instrumented_call::remove, r), [&] { return _db.remove(r); });
+    }
+
+    auto execute(const std::string& statement) -> decltype(std::declval<Db&>().execute(statement))
+    {
+      if (not _reporter)
+        return _db.execute(statement);
+      detail::instrumented_execution_t execution{execution_timing_t{instrumented_call::execute}};
+      execution.timing.sql_bytes = statement.size();
+      if (_reporter.recorder)
+        execution.sql = statement;
+      return _timed(std::move(execution), [&] { return _db.execute(statement); });
+    }
+
+    template <
+        typename Statement,
+        typename Enable = typename std::enable_if<not std::is_convertible<Statement, std::string>::value, void>::type,
+        typename D = Db>
+    auto execute(const Statement& s) -> decltype(std::declval<D&>().execute(s))
+    {
+      if (not _reporter)
+        return _db.execute(s);
+      return _timed(_serialize(instrumented_call::execute, s), [&] { return _db.execute(s); });
+    }
+
+    // Prepared statements start here
+    template <typename T>
+    auto _prepare(const T& t, ::sqlpp::consistent_t) -> decltype(t._prepare(*this))
+    {
+      return t._prepare(*this);
+    }
+
+    template <typename Check, typename T>
+    auto _prepare(const T& t, Check) -> Check;
+
+    template <typename T>
+    auto prepare(const T& t) -> decltype(this->_prepare(t, sqlpp::prepare_check_t<_serializer_context_t, T>{}))
+    {
+      return _prepare(t, sqlpp::prepare_check_t<_serializer_context_t, T>{});
+    }
+
+    template <typename Select, typename D = Db>
+    auto prepare_select(Select& s)
+        -> decltype(_prepared_statement_t(std::declval<D&>().prepare_select(s), {}))
+    {
+      if (not _reporter)
+        return {_db.prepare_select(s), {}};
+      return _timed_prepare(_serialize(instrumented_call::prepare_select, s),
+                            [&] { return _db.prepare_select(s); });
+    }
+
+    template <typename Insert, typename D = Db>
+    auto prepare_insert(Insert& i)
+        -> decltype(_prepared_statement_t(std::declval<D&>().prepare_insert(i), {}))
+    {
+      if (not _reporter)
+        return {_db.prepare_insert(i), {}};
+      return _timed_prepare(_serialize(instrumented_call::prepare_insert, i),
+                            [&] { return _db.prepare_insert(i); });
+    }
+
+    template <typename Update, typename D = Db>
+    auto prepare_update(Update& u)
+        -> decltype(_prepared_statement_t(std::declval<D&>().prepare_update(u), {}))
+    {
+      if (not _reporter)
+        return {_db.prepare_update(u), {}};
+      return _timed_prepare(_serialize(instrumented_call::prepare_update, u),
+                            [&] { return _db.prepare_update(u); });
+    }
+
+    template <typename Remove, typename D = Db>
+    auto prepare_remove(Remove& r)
+        -> decltype(_prepared_statement_t(std::declval<D&>().prepare_remove(r), {}))
+    {
+      if (not _reporter)
+        return {_db.prepare_remove(r), {}};
+      return _timed_prepare(_serialize(instrumented_call::prepare_remove, r),
+                            [&] { return _db.prepare_remove(r); });
+    }
+
+    template <typename Statement, typename D = Db>
+    auto prepare_execute(Statement& s)
+        -> decltype(_prepared_statement_t(std::declval<D&>().prepare_execute(s), {}))
+    {
+      if (not _reporter)
+        return {_db.prepare_execute(s), {}};
+      return _timed_prepare(_serialize(instrumented_call::prepare_execute, s),
+                            [&] { return _db.prepare_execute(s); });
+    }
+
+    template <typename PreparedSelect, typename D = Db>
+    auto run_prepared_select(PreparedSelect& s)
+        -> instrumented_result_t<decltype(std::declval<D&>().run_prepared_select(s))>
+    {
+      if (not _reporter)
+        return {_db.run_prepared_select(s)};
+      return _timed_select(_prepared_timing(instrumented_call::run_prepared_select, s),
+                           [&] { return _db.run_prepared_select(s); });
+    }
+
+    template <typename PreparedInsert, typename D = Db>
+    auto run_prepared_insert(PreparedInsert& i) -> decltype(std::declval<D&>().run_prepared_insert(i))
+    {
+      if (not _reporter)
+        return _db.run_prepared_insert(i);
+      return _timed(_prepared_timing(instrumented_call::run_prepared_insert, i),
+                    [&] { return _db.run_prepared_insert(i); });
+    }
+
+    template <typename PreparedUpdate, typename D = Db>
+    auto run_prepared_update(PreparedUpdate& u) -> decltype(std::declval<D&>().run_prepared_update(u))
+    {
+      if (not _reporter)
+        return _db.run_prepared_update(u);
+      return _timed(_prepared_timing(instrumented_call::run_prepared_update, u),
+                    [&] { return _db.run_prepared_update(u); });
+    }
+
+    template <typename PreparedRemove, typename D = Db>
+    auto run_prepared_remove(PreparedRemove& r) -> decltype(std::declval<D&>().run_prepared_remove(r))
+    {
+      if (not _reporter)
+        return _db.run_prepared_remove(r);
+      return _timed(_prepared_timing(instrumented_call::run_prepared_remove, r),
+                    [&] { return _db.run_prepared_remove(r); });
+    }
+
+    template <typename PreparedExecute, typename D = Db>
+    auto run_prepared_execute(PreparedExecute& s) -> decltype(std::declval<D&>().run_prepared_execute(s))
+    {
+      if (not _reporter)
+        return _db.run_prepared_execute(s);
+      return _timed(_prepared_timing(instrumented_call::run_prepared_execute, s),
+                    [&] { return _db.run_prepared_execute(s); });
+    }
+
+    void start_transaction()
+    {
+      if (not _reporter)
+        return _db.start_transaction();
+      _timed_void(execution_timing_t{instrumented_call::start_transaction}, [&] { _db.start_transaction(); });
+    }
+
+    void start_transaction(isolation_level level, transaction_access access)
+    {
+      if (not _reporter)
+        return _db.start_transaction(level, access);
+      _timed_void(execution_timing_t{instrumented_call::start_transaction},
+                  [&] { _db.start_transaction(level, access); });
+    }
+
+    void commit_transaction()
+    {
+      if (not _reporter)
+        return _db.commit_transaction();
+      _timed_void(execution_timing_t{instrumented_call::commit_transaction}, [&] { _db.commit_transaction(); });
+    }
+
+    void rollback_transaction(bool report)
+    {
+      if (not _reporter)
+        return _db.rollback_transaction(report);
+      _timed_void(execution_timing_t{instrumented_call::rollback_transaction},
+                  [&] { _db.rollback_transaction(report); });
+    }
+
+    void report_rollback_failure(const std::string& message) noexcept
+    {
+      _db.report_rollback_failure(message);
+    }
+  };
+}
+
+#endif
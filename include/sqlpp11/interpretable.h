@@ -27,8 +27,9 @@
 #ifndef SQLPP_INTERPRETABLE_H
 #define SQLPP_INTERPRETABLE_H
 
-#include <memory>
 #include <sqlpp11/serializer_context.h>
+#include <sqlpp11/fingerprint.h>
+#include <sqlpp11/detail/small_buffer_ptr.h>
 #include <sqlpp11/parameter_list.h>
 #include <sqlpp11/serialize.h>
 #include <sqlpp11/interpret.h>
@@ -43,7 +44,7 @@ namespace sqlpp
 
     template <typename T>
     interpretable_t(T t)
-        : _requires_braces(requires_braces_t<T>::value), _impl(std::make_shared<_impl_t<T>>(t))
+        : _requires_braces(requires_braces_t<T>::value), _impl(_impl_ptr_t::template make<_impl_t<T>>(std::move(t)))
     {
     }
 
@@ -73,21 +74,28 @@ namespace sqlpp
       return _impl->interpret(context);
     }
 
+    fingerprint_context_t& fingerprint(fingerprint_context_t& context) const
+    {
+      return _impl->fingerprint(context);
+    }
+
     bool _requires_braces;
 
   private:
     struct _impl_base
     {
+      virtual ~_impl_base() = default;
       virtual serializer_context_t& serialize(serializer_context_t& context) const = 0;
       virtual _serializer_context_t& db_serialize(_serializer_context_t& context) const = 0;
       virtual _interpreter_context_t& interpret(_interpreter_context_t& context) const = 0;
+      virtual fingerprint_context_t& fingerprint(fingerprint_context_t& context) const = 0;
     };
 
     template <typename T>
     struct _impl_t : public _impl_base
     {
       static_assert(not make_parameter_list_t<T>::size::value, "parameters not supported in dynamic statement parts");
-      _impl_t(T t) : _t(t)
+      _impl_t(T t) : _t(std::move(t))
       {
       }
 
@@ -109,10 +117,43 @@ namespace sqlpp
         return context;
       }
 
+      fingerprint_context_t& fingerprint(fingerprint_context_t& context) const
+      {
+        context.add_type<T>();
+        using _is_serializable = serialize_check_t<fingerprint_context_t, T>;
+        return _fingerprint(context, std::integral_constant<bool, _is_serializable::value>{});
+      }
+
+      fingerprint_context_t& _fingerprint(fingerprint_context_t& context, const std::true_type&) const
+      {
+        ::sqlpp::serialize(_t, context);
+        return context;
+      }
+
+      // Without a generic serializer, the type has to suffice
+      fingerprint_context_t& _fingerprint(fingerprint_context_t& context, const std::false_type&) const
+      {
+        return context;
+      }
+
       T _t;
     };
 
-    std::shared_ptr<const _impl_base> _impl;
+    // Typical dynamic conditions and columns are stored inline, see detail::small_buffer_ptr
+    using _impl_ptr_t = detail::small_buffer_ptr<_impl_base, 80>;
+    _impl_ptr_t _impl;
+  };
+
+  template <typename Database>
+  struct serializer_t<fingerprint_context_t, interpretable_t<Database>>
+  {
+    using _serialize_check = consistent_t;
+    using T = interpretable_t<Database>;
+
+    static fingerprint_context_t& _(const T& t, fingerprint_context_t& context)
+    {
+      return t.fingerprint(context);
+    }
   };
 
   template <typename Context, typename Database>
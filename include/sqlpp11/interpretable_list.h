@@ -27,6 +27,7 @@
 #ifndef SQLPP_INTERPRETABLE_LIST_H
 #define SQLPP_INTERPRETABLE_LIST_H
 
+#include <sqlpp11/arena.h>
 #include <sqlpp11/interpretable.h>
 #include <vector>
 
@@ -35,7 +36,7 @@ namespace sqlpp
   template <typename Db>
   struct interpretable_list_t
   {
-    std::vector<interpretable_t<Db>> _serializables;
+    std::vector<interpretable_t<Db>, arena_allocator<interpretable_t<Db>>> _serializables;
 
     std::size_t size() const
     {
@@ -52,6 +53,16 @@ namespace sqlpp
     {
       _serializables.emplace_back(expr);
     }
+
+    void clear()
+    {
+      _serializables.clear();
+    }
+
+    void _use_arena(arena_t* arena)
+    {
+      detail::move_to_arena(_serializables, arena);
+    }
   };
 
   template <>
@@ -66,6 +77,10 @@ namespace sqlpp
     {
       return true;
     }
+
+    void _use_arena(arena_t*)
+    {
+    }
   };
 
   template <typename Context, typename List>
@@ -77,7 +92,7 @@ namespace sqlpp
     static Context& _(const T& t, const Separator& separator, Context& context)
     {
       bool first = true;
-      for (const auto entry : t._serializables)
+      for (const auto& entry : t._serializables)
       {
         if (not first)
         {
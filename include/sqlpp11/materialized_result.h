@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_MATERIALIZED_RESULT_H
+#define SQLPP_MATERIALIZED_RESULT_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <sqlpp11/result.h>
+#include <sqlpp11/result_row.h>
+
+namespace sqlpp
+{
+  namespace detail
+  {
+    template <typename Db, std::size_t NextIndex, std::size_t... Is, typename... FieldSpecs>
+    void copy_result_fields(result_row_impl<Db, field_index_sequence<NextIndex, Is...>, FieldSpecs...>& target,
+                            const result_row_impl<Db, field_index_sequence<NextIndex, Is...>, FieldSpecs...>& source)
+    {
+      using swallow = int[];
+      (void)swallow{0, (static_cast<result_field<Db, Is, FieldSpecs>&>(target) =
+                            static_cast<const result_field<Db, Is, FieldSpecs>&>(source),
+                        0)...};
+    }
+
+    template <typename Db, typename... FieldSpecs>
+    void copy_result_row(result_row_t<Db, FieldSpecs...>& target, const result_row_t<Db, FieldSpecs...>& source)
+    {
+      copy_result_fields(target, source);
+      target._is_valid = source._is_valid;
+    }
+
+    template <typename Db, typename... FieldSpecs>
+    void copy_result_row(dynamic_result_row_t<Db, FieldSpecs...>& target,
+                         const dynamic_result_row_t<Db, FieldSpecs...>& source)
+    {
+      copy_result_fields(target, source);
+      target._is_valid = source._is_valid;
+      target._dynamic_field_names = source._dynamic_field_names;
+      target._dynamic_fields = source._dynamic_fields;
+    }
+
+    // Plays the role of the connector's result for result_t, replaying rows that are shared by any number of results
+    template <typename ResultRow>
+    class materialized_db_result_t
+    {
+      std::shared_ptr<const std::vector<ResultRow>> _rows;
+      std::size_t _next = 0;
+
+    public:
+      materialized_db_result_t() = default;
+
+      materialized_db_result_t(std::shared_ptr<const std::vector<ResultRow>> rows) : _rows(std::move(rows))
+      {
+      }
+
+      void next(ResultRow& result_row)
+      {
+        if (_rows and _next < _rows->size())
+          copy_result_row(result_row, (*_rows)[_next++]);
+        else
+          result_row._invalidate();
+      }
+    };
+
+    template <typename Db, typename Select>
+    std::shared_ptr<const std::vector<typename Select::template _result_row_t<Db>>> materialize_rows(Db& db,
+                                                                                                    const Select& s)
+    {
+      auto rows = std::make_shared<std::vector<typename Select::template _result_row_t<Db>>>();
+      // a copy of the names, rows must not use the statement's arena as they outlive the statement
+      const auto dynamic_names = s.get_dynamic_names();
+      for (const auto& row : db(s))
+      {
+        rows->emplace_back(dynamic_names);
+        copy_result_row(rows->back(), row);
+      }
+      return rows;
+    }
+  }
+
+  // A result whose rows have been read completely and are immutable. Copies of the rows can be shared between
+  // threads, each result iterates them independently of the connection.
+  template <typename ResultRow>
+  using materialized_result_t = result_t<detail::materialized_db_result_t<ResultRow>, ResultRow>;
+
+  template <typename Db, typename Select>
+  auto materialize(Db& db, const Select& s) -> materialized_result_t<typename Select::template _result_row_t<Db>>
+  {
+    using _db_result_t = detail::materialized_db_result_t<typename Select::template _result_row_t<Db>>;
+    return {_db_result_t{detail::materialize_rows(db, s)}, s.get_dynamic_names()};
+  }
+}
+
+#endif
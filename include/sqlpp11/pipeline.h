@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_PIPELINE_H
+#define SQLPP_PIPELINE_H
+
+#include <tuple>
+#include <utility>
+#include <sqlpp11/async.h>
+#include <sqlpp11/logic.h>
+#include <sqlpp11/detail/index_sequence.h>
+#include <sqlpp11/detail/void.h>
+
+namespace sqlpp
+{
+  namespace detail
+  {
+    template <typename Db, typename Statement, typename Enable = void>
+    struct can_run_async : std::false_type
+    {
+    };
+
+    template <typename Db, typename Statement>
+    struct can_run_async<
+        Db,
+        Statement,
+        void_t<decltype(sqlpp::async(std::declval<Db&>(), std::declval<const Statement&>()))>> : std::true_type
+    {
+    };
+
+    template <typename Db, typename Enable = void>
+    struct has_pipeline_mode : std::false_type
+    {
+    };
+
+    template <typename Db>
+    struct has_pipeline_mode<
+        Db,
+        void_t<decltype(std::declval<Db&>().begin_pipeline(), std::declval<Db&>().end_pipeline())>> : std::true_type
+    {
+    };
+
+    // Ends the pipeline mode even if sending one of the statements failed
+    template <typename Db>
+    struct pipeline_mode_guard_t
+    {
+      Db& _db;
+
+      pipeline_mode_guard_t(Db& db) : _db(db)
+      {
+        _db.begin_pipeline();
+      }
+
+      pipeline_mode_guard_t(const pipeline_mode_guard_t&) = delete;
+      pipeline_mode_guard_t& operator=(const pipeline_mode_guard_t&) = delete;
+
+      ~pipeline_mode_guard_t()
+      {
+        _db.end_pipeline();
+      }
+    };
+  }
+
+  // A sequence of statements that is sent to the database without waiting for the individual results.
+  // This requires the pipeline mode of the asynchronous connector interface (begin_pipeline() and end_pipeline(),
+  // see connector_api/async_connection.h) and asynchronous execution of all statements.
+  // Otherwise the statements are executed one after the other.
+  // Either way, the statements are sent and executed in the order in which they were added.
+  // The results are returned as a tuple in the order of the statements.
+  template <typename Db, typename... Statements>
+  class pipeline_t
+  {
+    Db& _db;
+    std::tuple<Statements...> _statements;
+
+    using _is_native = logic::all_t<detail::has_pipeline_mode<Db>::value,
+                                    detail::can_run_async<Db, Statements>::value...>;
+
+    template <typename Statement>
+    static auto _async_result(Db& db, const Statement& statement) -> decltype(sqlpp::async(db, statement).get());
+
+    template <typename Statement>
+    static auto _sync_result(Db& db, const Statement& statement) -> decltype(db(statement));
+
+    template <typename... Handles>
+    static std::tuple<decltype(std::declval<Handles&>().get())...> _collect(Handles&... handles)
+    {
+      // braced initialization guarantees the order of evaluation
+      return std::tuple<decltype(std::declval<Handles&>().get())...>{handles.get()...};
+    }
+
+    template <std::size_t... Is>
+    auto _send(const detail::index_sequence<Is...>&)
+        -> std::tuple<decltype(sqlpp::async(_db, std::get<Is>(_statements)))...>
+    {
+      const detail::pipeline_mode_guard_t<Db> pipeline_mode(_db);
+      // braced initialization guarantees the order of submission
+      return std::tuple<decltype(sqlpp::async(_db, std::get<Is>(_statements)))...>{
+          sqlpp::async(_db, std::get<Is>(_statements))...};
+    }
+
+    template <std::size_t... Is>
+    auto _run(const std::true_type&, const detail::index_sequence<Is...>&)
+        -> std::tuple<decltype(_async_result(_db, std::get<Is>(_statements)))...>
+    {
+      // send everything first
+      auto handles = _send(detail::index_sequence<Is...>{});
+      // then wait for the results
+      return _collect(std::get<Is>(handles)...);
+    }
+
+    template <std::size_t... Is>
+    auto _run(const std::false_type&, const detail::index_sequence<Is...>&)
+        -> std::tuple<decltype(_sync_result(_db, std::get<Is>(_statements)))...>
+    {
+      return std::tuple<decltype(_sync_result(_db, std::get<Is>(_statements)))...>{_db(std::get<Is>(_statements))...};
+    }
+
+  public:
+    pipeline_t(Db& db, std::tuple<Statements...> statements) : _db(db), _statements(std::move(statements))
+    {
+    }
+
+    static constexpr bool is_native()
+    {
+      return _is_native::value;
+    }
+
+    static constexpr std::size_t size()
+    {
+      return sizeof...(Statements);
+    }
+
+    template <typename Statement>
+    auto add(Statement statement) const & -> pipeline_t<Db, Statements..., Statement>
+    {
+      static_assert(is_statement_t<Statement>::value, "pipeline::add() requires a statement");
+      return {_db, std::tuple_cat(_statements, std::tuple<Statement>{std::move(statement)})};
+    }
+
+    // Chained calls move the statements instead of copying them again for each call
+    template <typename Statement>
+    auto add(Statement statement) && -> pipeline_t<Db, Statements..., Statement>
+    {
+      static_assert(is_statement_t<Statement>::value, "pipeline::add() requires a statement");
+      return {_db, std::tuple_cat(std::move(_statements), std::tuple<Statement>{std::move(statement)})};
+    }
+
+    auto run() -> decltype(this->_run(_is_native{}, detail::make_index_sequence<sizeof...(Statements)>{}))
+    {
+      return _run(_is_native{}, detail::make_index_sequence<sizeof...(Statements)>{});
+    }
+  };
+
+  template <typename Db>
+  pipeline_t<Db> pipeline(Db& db)
+  {
+    return {db, std::tuple<>{}};
+  }
+}
+
+#endif
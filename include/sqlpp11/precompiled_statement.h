@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_PRECOMPILED_STATEMENT_H
+#define SQLPP_PRECOMPILED_STATEMENT_H
+
+#include <type_traits>
+#include <utility>
+#include <sqlpp11/exception.h>
+#include <sqlpp11/prepared_execute.h>
+#include <sqlpp11/prepared_insert.h>
+#include <sqlpp11/prepared_remove.h>
+#include <sqlpp11/prepared_select.h>
+#include <sqlpp11/prepared_update.h>
+#include <sqlpp11/result.h>
+#include <sqlpp11/serialize.h>
+#include <sqlpp11/type_traits.h>
+
+namespace sqlpp
+{
+  namespace detail
+  {
+    // Only the branch matching the statement's checks is instantiated.
+    template <typename Result, typename Db, typename Statement>
+    Result precompiled_run(Db& db, Statement& statement, std::true_type)
+    {
+      return db(statement);
+    }
+
+    template <typename Result, typename Db, typename Statement>
+    Result precompiled_run(Db&, Statement&, std::false_type)
+    {
+      throw exception("Statement cannot be run");
+    }
+
+    template <typename Result, typename Db, typename Statement>
+    Result precompiled_prepare(Db& db, const Statement& statement, std::true_type)
+    {
+      return db.prepare(statement);
+    }
+
+    template <typename Result, typename Db, typename Statement>
+    Result precompiled_prepare(Db&, const Statement&, std::false_type)
+    {
+      throw exception("Statement cannot be prepared");
+    }
+  }
+
+  // Entry points for one statement type and one connection type. The member functions are deliberately defined
+  // out of class (i.e. not inline), so that with SQLPP_EXTERN_STATEMENT, the serializer, _run, _prepare and the
+  // result row code of the statement are instantiated only once, in the translation unit that uses
+  // SQLPP_INSTANTIATE_STATEMENT.
+  //
+  //   // statements.h
+  //   using find_users_t = decltype(select(all_of(users)).from(users).where(users.name == parameter(users.name)));
+  //   SQLPP_EXTERN_STATEMENT(my_connection, find_users_t)
+  //
+  //   // statements.cpp
+  //   SQLPP_INSTANTIATE_STATEMENT(my_connection, find_users_t)
+  //
+  //   // anywhere else
+  //   auto prepared = sqlpp::precompiled_prepare(db, find_users);
+  //   for (const auto& row : sqlpp::precompiled_run(db, prepared)) ...
+  //
+  // Since all members are instantiated explicitly, running a statement that can only be prepared (or vice versa)
+  // must not fail to compile here. The precompiled_run and precompiled_prepare functions below check at the call site.
+  template <typename Db, typename Statement>
+  struct precompiled_statement_t
+  {
+    using _context_t = typename Db::_serializer_context_t;
+    using _run_check = run_check_t<_context_t, Statement>;
+    using _prepare_check = prepare_check_t<_context_t, Statement>;
+    using _run_result_t = decltype(std::declval<Db&>()(std::declval<const Statement&>()));
+    using _prepared_t = decltype(std::declval<Db&>().prepare(std::declval<const Statement&>()));
+    using _run_prepared_result_t = decltype(std::declval<Db&>()(std::declval<_prepared_t&>()));
+
+    static _context_t& serialize(const Statement& statement, _context_t& context);
+    static _run_result_t run(Db& db, const Statement& statement);
+    static _prepared_t prepare(Db& db, const Statement& statement);
+    static _run_prepared_result_t run(Db& db, _prepared_t& prepared);
+
+  };
+
+  template <typename Db, typename Statement>
+  auto precompiled_statement_t<Db, Statement>::serialize(const Statement& statement, _context_t& context)
+      -> _context_t&
+  {
+    return ::sqlpp::serialize(statement, context);
+  }
+
+  template <typename Db, typename Statement>
+  auto precompiled_statement_t<Db, Statement>::run(Db& db, const Statement& statement) -> _run_result_t
+  {
+    return detail::precompiled_run<_run_result_t>(db, statement, std::is_same<_run_check, consistent_t>{});
+  }
+
+  template <typename Db, typename Statement>
+  auto precompiled_statement_t<Db, Statement>::prepare(Db& db, const Statement& statement) -> _prepared_t
+  {
+    return detail::precompiled_prepare<_prepared_t>(db, statement, std::is_same<_prepare_check, consistent_t>{});
+  }
+
+  template <typename Db, typename Statement>
+  auto precompiled_statement_t<Db, Statement>::run(Db& db, _prepared_t& prepared) -> _run_prepared_result_t
+  {
+    return detail::precompiled_run<_run_prepared_result_t>(db, prepared,
+                                                          std::is_same<_prepare_check, consistent_t>{});
+  }
+
+  namespace detail
+  {
+    template <typename Db, typename Prepared>
+    struct precompiled_of;
+
+    template <typename Db, typename Statement>
+    struct precompiled_of<Db, prepared_select_t<Db, Statement>>
+    {
+      using type = precompiled_statement_t<Db, Statement>;
+    };
+
+    template <typename Db, typename Statement>
+    struct precompiled_of<Db, prepared_insert_t<Db, Statement>>
+    {
+      using type = precompiled_statement_t<Db, Statement>;
+    };
+
+    template <typename Db, typename Statement>
+    struct precompiled_of<Db, prepared_update_t<Db, Statement>>
+    {
+      using type = precompiled_statement_t<Db, Statement>;
+    };
+
+    template <typename Db, typename Statement>
+    struct precompiled_of<Db, prepared_remove_t<Db, Statement>>
+    {
+      using type = precompiled_statement_t<Db, Statement>;
+    };
+
+    template <typename Db, typename Statement>
+    struct precompiled_of<Db, prepared_execute_t<Db, Statement>>
+    {
+      using type = precompiled_statement_t<Db, Statement>;
+    };
+  }
+
+  template <typename Db, typename Statement>
+  auto precompiled_run(Db& db, const Statement& statement) ->
+      typename precompiled_statement_t<Db, Statement>::_run_result_t
+  {
+    using _check = typename precompiled_statement_t<Db, Statement>::_run_check;
+    _check{};
+
+    return precompiled_statement_t<Db, Statement>::run(db, statement);
+  }
+
+  template <typename Db, typename Prepared>
+  auto precompiled_run(Db& db, Prepared& prepared) ->
+      typename detail::precompiled_of<Db, Prepared>::type::_run_prepared_result_t
+  {
+    return detail::precompiled_of<Db, Prepared>::type::run(db, prepared);
+  }
+
+  template <typename Db, typename Statement>
+  auto precompiled_prepare(Db& db, const Statement& statement) ->
+      typename precompiled_statement_t<Db, Statement>::_prepared_t
+  {
+    using _check = typename precompiled_statement_t<Db, Statement>::_prepare_check;
+    _check{};
+
+    return precompiled_statement_t<Db, Statement>::prepare(db, statement);
+  }
+}
+
+// The statement type must not contain unparenthesized commas, use an alias if necessary.
+#define SQLPP_EXTERN_STATEMENT(Db, Statement)                                          \
+  extern template struct ::sqlpp::precompiled_statement_t<Db, Statement>;              \
+  extern template struct ::sqlpp::serializer_t<Db::_serializer_context_t, Statement>;
+
+#define SQLPP_INSTANTIATE_STATEMENT(Db, Statement)                              \
+  template struct ::sqlpp::precompiled_statement_t<Db, Statement>;              \
+  template struct ::sqlpp::serializer_t<Db::_serializer_context_t, Statement>;
+
+#endif
@@ -43,93 +43,38 @@ namespace sqlpp
     struct result_row_impl;
 
     template <typename Db, std::size_t index, typename FieldSpec>
-    struct result_field : public member_t<FieldSpec, result_field_t<Db, FieldSpec>>
+    struct result_field_member
     {
-      using _field = member_t<FieldSpec, result_field_t<Db, FieldSpec>>;
-
-      result_field() = default;
-
-      void _validate()
-      {
-        _field::operator()()._validate();
-      }
-
-      void _invalidate()
-      {
-        _field::operator()()._invalidate();
-      }
-
-      template <typename Target>
-      void _bind(Target& target)
-      {
-        _field::operator()()._bind(target, index);
-      }
-
-      template <typename Target>
-      void _post_bind(Target& target)
-      {
-        _field::operator()()._post_bind(target, index);
-      }
-
-      template <typename Callable>
-      void _apply(Callable& callable) const
-      {
-        callable(_field::operator()());
-      }
-
-      template <typename Callable>
-      void _apply(const Callable& callable) const
-      {
-        callable(_field::operator()());
-      }
+      using type = member_t<FieldSpec, result_field_t<Db, FieldSpec>>;
     };
 
     template <std::size_t index, typename AliasProvider, typename Db, typename... FieldSpecs>
-    struct result_field<Db, index, multi_field_spec_t<AliasProvider, std::tuple<FieldSpecs...>>>
-        : public member_t<AliasProvider,
-                          result_row_impl<Db, detail::make_field_index_sequence<index, FieldSpecs...>, FieldSpecs...>>
+    struct result_field_member<Db, index, multi_field_spec_t<AliasProvider, std::tuple<FieldSpecs...>>>
     {
-      using _multi_field =
+      using type =
           member_t<AliasProvider,
                    result_row_impl<Db, detail::make_field_index_sequence<index, FieldSpecs...>, FieldSpecs...>>;
+    };
 
-      result_field() = default;
-
-      void _validate()
-      {
-        _multi_field::operator()()._validate();
-      }
-
-      void _invalidate()
-      {
-        _multi_field::operator()()._invalidate();
-      }
-
-      template <typename Target>
-      void _bind(Target& target)
-      {
-        _multi_field::operator()()._bind(target);
-      }
-
-      template <typename Target>
-      void _post_bind(Target& target)
-      {
-        _multi_field::operator()()._post_bind(target);
-      }
+    // The named member of a row, e.g. row.id, holding either a field or the nested row of a multi_column
+    template <typename Db, std::size_t index, typename FieldSpec>
+    using result_field = typename result_field_member<Db, index, FieldSpec>::type;
 
-      template <typename Callable>
-      void _apply(Callable& callable) const
-      {
-        _multi_field::operator()()._apply(callable);
-      }
+    template <typename Db, typename FieldSpec, typename Callable>
+    void apply_result_field(const result_field_t<Db, FieldSpec>& field, Callable& callable)
+    {
+      callable(field);
+    }
 
-      template <typename Callable>
-      void _apply(const Callable& callable) const
-      {
-        _multi_field::operator()()._apply(callable);
-      }
-    };
+    template <typename Db, typename IndexSequence, typename... FieldSpecs, typename Callable>
+    void apply_result_field(const result_row_impl<Db, IndexSequence, FieldSpecs...>& row, Callable& callable)
+    {
+      row._apply(callable);
+    }
 
+    // The fields are direct bases of the row. Each field keeps its own value, NULL flag and validity flag:
+    // Connectors bind fields as (index, value*, bool* is_null) and row.column.is_null() has no way back to
+    // the row, so neither a null bitmap nor values grouped by type are possible without breaking connectors.
     template <typename Db, std::size_t NextIndex, std::size_t... Is, typename... FieldSpecs>
     struct result_row_impl<Db, detail::field_index_sequence<NextIndex, Is...>, FieldSpecs...>
         : public result_field<Db, Is, FieldSpecs>...
@@ -139,41 +84,56 @@ namespace sqlpp
       void _validate()
       {
         using swallow = int[];
-        (void)swallow{(result_field<Db, Is, FieldSpecs>::_validate(), 0)...};
+        (void)swallow{0, (static_cast<result_field<Db, Is, FieldSpecs>&>(*this)()._validate(), 0)...};
       }
 
       void _invalidate()
       {
         using swallow = int[];
-        (void)swallow{(result_field<Db, Is, FieldSpecs>::_invalidate(), 0)...};
+        (void)swallow{0, (static_cast<result_field<Db, Is, FieldSpecs>&>(*this)()._invalidate(), 0)...};
       }
 
       template <typename Target>
       void _bind(Target& target)
       {
         using swallow = int[];
-        (void)swallow{(result_field<Db, Is, FieldSpecs>::_bind(target), 0)...};
+        (void)swallow{0, (static_cast<result_field<Db, Is, FieldSpecs>&>(*this)()._bind(target, Is), 0)...};
+      }
+
+      // Nested rows of multi_columns know the indexes of their fields
+      template <typename Target>
+      void _bind(Target& target, std::size_t)
+      {
+        _bind(target);
       }
 
       template <typename Target>
       void _post_bind(Target& target)
       {
         using swallow = int[];
-        (void)swallow{(result_field<Db, Is, FieldSpecs>::_post_bind(target), 0)...};
+        (void)swallow{0, (static_cast<result_field<Db, Is, FieldSpecs>&>(*this)()._post_bind(target, Is), 0)...};
+      }
+
+      template <typename Target>
+      void _post_bind(Target& target, std::size_t)
+      {
+        _post_bind(target);
       }
 
       template <typename Callable>
       void _apply(Callable& callable) const
       {
         using swallow = int[];
-        (void)swallow{(result_field<Db, Is, FieldSpecs>::_apply(callable), 0)...};
+        (void)swallow{
+            0, (apply_result_field(static_cast<const result_field<Db, Is, FieldSpecs>&>(*this)(), callable), 0)...};
       }
 
       template <typename Callable>
       void _apply(const Callable& callable) const
       {
         using swallow = int[];
-        (void)swallow{(result_field<Db, Is, FieldSpecs>::_apply(callable), 0)...};
+        (void)swallow{
+            0, (apply_result_field(static_cast<const result_field<Db, Is, FieldSpecs>&>(*this)(), callable), 0)...};
       }
     };
   }
@@ -273,18 +233,29 @@ namespace sqlpp
     using _impl = detail::result_row_impl<Db, _field_index_sequence, FieldSpecs...>;
     using _field_type = result_field_t<Db, field_spec_t<no_name_t, text, true, true>>;
 
+    using _names_t = typename dynamic_select_column_list<Db>::_names_t;
+    using _fields_t = std::map<std::string,
+                               _field_type,
+                               std::less<std::string>,
+                               arena_allocator<std::pair<const std::string, _field_type>>>;
+
     bool _is_valid;
-    std::vector<std::string> _dynamic_field_names;
-    std::map<std::string, _field_type> _dynamic_fields;
+    _names_t _dynamic_field_names;
+    _fields_t _dynamic_fields;
 
     dynamic_result_row_t() : _impl(), _is_valid(false)
     {
     }
 
-    dynamic_result_row_t(const std::vector<std::string>& dynamic_field_names)
-        : _impl(), _is_valid(false), _dynamic_field_names(dynamic_field_names)
+    // The dynamic fields use the allocator of the names, i.e. the statement's arena, see with_arena().
+    // Their names (the map keys) and text values are std::strings, which still allocate from the heap.
+    dynamic_result_row_t(const _names_t& dynamic_field_names)
+        : _impl(),
+          _is_valid(false),
+          _dynamic_field_names(dynamic_field_names, dynamic_field_names.get_allocator()),
+          _dynamic_fields(typename _fields_t::allocator_type(dynamic_field_names.get_allocator()))
     {
-      for (auto field_name : _dynamic_field_names)
+      for (const auto& field_name : _dynamic_field_names)
       {
         _dynamic_fields.insert({field_name, _field_type{}});
       }
@@ -364,7 +335,7 @@ namespace sqlpp
       std::size_t index = _field_index_sequence::_next_index;
       for (const auto& field_name : _dynamic_field_names)
       {
-        _dynamic_fields.at(field_name)._apply(callable);
+        callable(_dynamic_fields.at(field_name));
         ++index;
       }
     }
@@ -377,7 +348,7 @@ namespace sqlpp
       std::size_t index = _field_index_sequence::_next_index;
       for (const auto& field_name : _dynamic_field_names)
       {
-        _dynamic_fields.at(field_name)._apply(callable);
+        callable(_dynamic_fields.at(field_name));
         ++index;
       }
     }
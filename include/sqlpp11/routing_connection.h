@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_ROUTING_CONNECTION_H
+#define SQLPP_ROUTING_CONNECTION_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <sqlpp11/connection.h>
+#include <sqlpp11/exception.h>
+#include <sqlpp11/prepared_select.h>
+#include <sqlpp11/transaction.h>
+#include <sqlpp11/type_traits.h>
+
+namespace sqlpp
+{
+  struct routing_config_t
+  {
+    // After a write, reads are sent to the primary for this long, so that callers see their own changes
+    // despite replication lag.
+    std::chrono::milliseconds read_your_writes = std::chrono::milliseconds{0};
+  };
+
+  namespace detail
+  {
+    template <typename T>
+    struct is_prepared_select : std::false_type
+    {
+    };
+
+    template <typename Database, typename Statement, typename Composite>
+    struct is_prepared_select<prepared_select_t<Database, Statement, Composite>> : std::true_type
+    {
+    };
+  }
+
+  // Sends selects to the read replicas (round robin) and everything else to the primary.
+  // Within a transaction and within the read-your-writes window, selects are sent to the primary, too.
+  // Prepared statements are prepared and run on the primary, prepared selects do not count as writes.
+  // The connections are not owned and must outlive the router. Like a connection, the router must not be used by
+  // several threads at the same time.
+  // The clock is a template parameter for testing the read-your-writes window.
+  template <typename Connection, typename Clock = std::chrono::steady_clock>
+  class routing_connection : public sqlpp::connection
+  {
+    using _clock_t = Clock;
+
+    Connection& _primary;
+    std::vector<Connection*> _replicas;
+    routing_config_t _config;
+    std::size_t _next_replica = 0;
+    std::size_t _open_transactions = 0;
+    bool _has_written = false;
+    typename _clock_t::time_point _last_write;
+
+    bool _reads_from_primary() const
+    {
+      return _replicas.empty() or _open_transactions > 0 or
+             (_has_written and _clock_t::now() - _last_write < _config.read_your_writes);
+    }
+
+    void _end_transaction()
+    {
+      if (_open_transactions > 0)
+        --_open_transactions;
+    }
+
+    template <typename T>
+    Connection& _route(const T&, const std::true_type& /* is read */)
+    {
+      // Prepared statements belong to the connection they were prepared on
+      if (is_prepared_statement_t<T>::value or _reads_from_primary())
+        return _primary;
+      auto& replica = *_replicas[_next_replica];
+      _next_replica = (_next_replica + 1) % _replicas.size();
+      return replica;
+    }
+
+    template <typename T>
+    Connection& _route(const T&, const std::false_type& /* is read */)
+    {
+      _has_written = true;
+      _last_write = _clock_t::now();
+      return _primary;
+    }
+
+  public:
+    using _traits = typename Connection::_traits;
+    using _serializer_context_t = typename Connection::_serializer_context_t;
+    using _interpreter_context_t = typename Connection::_interpreter_context_t;
+    using _prepared_statement_t = typename Connection::_prepared_statement_t;
+
+    template <typename Read>
+    using _is_read_t = logic::any_t<logic::all_t<is_statement_t<Read>::value, has_result_row_t<Read>::value>::value,
+                                    detail::is_prepared_select<Read>::value>;
+
+    routing_connection(Connection& primary, std::vector<Connection*> replicas, routing_config_t config = {})
+        : _primary(primary), _replicas(std::move(replicas)), _config(config)
+    {
+      for (const auto replica : _replicas)
+      {
+        if (not replica)
+          throw sqlpp::exception("routing_connection: replica must not be null");
+      }
+    }
+
+    routing_connection(const routing_connection&) = delete;
+    routing_connection(routing_connection&&) = delete;
+    routing_connection& operator=(const routing_connection&) = delete;
+    routing_connection& operator=(routing_connection&&) = delete;
+    ~routing_connection() = default;
+
+    template <typename T>
+    static _serializer_context_t& _serialize_interpretable(const T& t, _serializer_context_t& context)
+    {
+      return Connection::_serialize_interpretable(t, context);
+    }
+
+    template <typename T>
+    static _interpreter_context_t& _interpret_interpretable(const T& t, _interpreter_context_t& context)
+    {
+      return Connection::_interpret_interpretable(t, context);
+    }
+
+    Connection& primary()
+    {
+      return _primary;
+    }
+
+    std::size_t replica_count() const
+    {
+      return _replicas.size();
+    }
+
+    Connection& replica(std::size_t index)
+    {
+      return *_replicas.at(index);
+    }
+
+    // The connection that the next select would be sent to
+    Connection& reader()
+    {
+      return _reads_from_primary() ? _primary : *_replicas[_next_replica];
+    }
+
+    template <typename T>
+    auto operator()(const T& t) -> decltype(std::declval<Connection&>()(t))
+    {
+      return _route(t, _is_read_t<T>{})(t);
+    }
+
+    template <typename T>
+    auto prepare(const T& t) -> decltype(std::declval<Connection&>().prepare(t))
+    {
+      return _primary.prepare(t);
+    }
+
+    template <typename Statement>
+    auto execute(const Statement& s) -> decltype(std::declval<Connection&>().execute(s))
+    {
+      _route(s, std::false_type{});
+      return _primary.execute(s);
+    }
+
+    void start_transaction()
+    {
+      _primary.start_transaction();
+      ++_open_transactions;
+    }
+
+    void start_transaction(isolation_level level, transaction_access access)
+    {
+      _primary.start_transaction(level, access);
+      ++_open_transactions;
+    }
+
+    // A failed commit leaves the transaction open, it is rolled back afterwards (e.g. by transaction_t)
+    void commit_transaction()
+    {
+      _primary.commit_transaction();
+      _end_transaction();
+    }
+
+    // A failed rollback ends the transaction, too, nobody is going to finish it
+    void rollback_transaction(bool report)
+    {
+      try
+      {
+        _primary.rollback_transaction(report);
+      }
+      catch (...)
+      {
+        _end_transaction();
+        throw;
+      }
+      _end_transaction();
+    }
+
+    void report_rollback_failure(const std::string& message) noexcept
+    {
+      _primary.report_rollback_failure(message);
+    }
+  };
+}
+
+#endif
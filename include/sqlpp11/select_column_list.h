@@ -86,6 +86,11 @@ namespace sqlpp
 
     std::tuple<Columns...> _columns;
     dynamic_select_column_list<Database> _dynamic_columns;
+
+    void _use_arena(arena_t* arena)
+    {
+      _dynamic_columns._use_arena(arena);
+    }
   };
 
   SQLPP_PORTABLE_STATIC_ASSERT(
@@ -143,6 +148,13 @@ namespace sqlpp
         _add_impl(namedExpression, ok());  // dispatch to prevent compile messages after the static_assert
       }
 
+      // Removes the dynamic parts, but keeps the allocated capacity for re-use (long column names are freed, though)
+      void clear()
+      {
+        static_assert(_is_dynamic::value, "selected_columns::clear() can only be called for dynamic_columns");
+        _data._dynamic_columns.clear();
+      }
+
       // private:
       template <typename NamedExpression>
       void _add_impl(NamedExpression namedExpression, const std::true_type&)
@@ -53,6 +53,11 @@ namespace sqlpp
 
     std::tuple<Flags...> _flags;
     interpretable_list_t<Database> _dynamic_flags;
+
+    void _use_arena(arena_t* arena)
+    {
+      _dynamic_flags._use_arena(arena);
+    }
   };
 
   // SELECT FLAGS
@@ -0,0 +1,683 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_SHARDED_CONNECTION_H
+#define SQLPP_SHARDED_CONNECTION_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <sqlpp11/aggregate_functions.h>
+#include <sqlpp11/connection.h>
+#include <sqlpp11/exception.h>
+#include <sqlpp11/select.h>
+#include <sqlpp11/detail/index_sequence.h>
+#include <sqlpp11/detail/type_vector.h>
+
+namespace sqlpp
+{
+  // Where the databases sort NULL, e.g. smallest for sqlite3 and MySQL, largest for PostgreSQL
+  enum class null_order
+  {
+    smallest,  // NULLS FIRST in ascending order, NULLS LAST in descending order
+    largest    // NULLS LAST in ascending order, NULLS FIRST in descending order
+  };
+
+  struct sharded_config_t
+  {
+    // Has to match the shards for order_by to be merged correctly
+    null_order nulls = null_order::smallest;
+    // Runs the selects of all but the first shard, e.g. on a thread pool. It is called with a std::function<void()>
+    // which must be run exactly once. Without executor, the shards are queried one after another.
+    std::function<void(std::function<void()>)> executor;
+  };
+
+  namespace detail
+  {
+    enum class shard_aggregate
+    {
+      none,
+      sum,
+      max,
+      min,
+      unsupported
+    };
+
+    template <typename Column>
+    struct shard_aggregate_of : std::integral_constant<shard_aggregate, shard_aggregate::none>
+    {
+    };
+
+    // Distinct values might be present on several shards, so distinct aggregates cannot be summed up
+    template <typename Flag, typename Expr, typename AliasProvider>
+    struct shard_aggregate_of<expression_alias_t<count_t<Flag, Expr>, AliasProvider>>
+        : std::integral_constant<shard_aggregate, shard_aggregate::unsupported>
+    {
+    };
+
+    template <typename Expr, typename AliasProvider>
+    struct shard_aggregate_of<expression_alias_t<count_t<noop, Expr>, AliasProvider>>
+        : std::integral_constant<shard_aggregate, shard_aggregate::sum>
+    {
+    };
+
+    template <typename Flag, typename Expr, typename AliasProvider>
+    struct shard_aggregate_of<expression_alias_t<sum_t<Flag, Expr>, AliasProvider>>
+        : std::integral_constant<shard_aggregate, shard_aggregate::unsupported>
+    {
+    };
+
+    template <typename Expr, typename AliasProvider>
+    struct shard_aggregate_of<expression_alias_t<sum_t<noop, Expr>, AliasProvider>>
+        : std::integral_constant<shard_aggregate, shard_aggregate::sum>
+    {
+    };
+
+    template <typename Expr, typename AliasProvider>
+    struct shard_aggregate_of<expression_alias_t<max_t<Expr>, AliasProvider>>
+        : std::integral_constant<shard_aggregate, shard_aggregate::max>
+    {
+    };
+
+    template <typename Expr, typename AliasProvider>
+    struct shard_aggregate_of<expression_alias_t<min_t<Expr>, AliasProvider>>
+        : std::integral_constant<shard_aggregate, shard_aggregate::min>
+    {
+    };
+
+    template <typename Flag, typename Expr, typename AliasProvider>
+    struct shard_aggregate_of<expression_alias_t<avg_t<Flag, Expr>, AliasProvider>>
+        : std::integral_constant<shard_aggregate, shard_aggregate::unsupported>
+    {
+    };
+
+    template <shard_aggregate... Aggregates>
+    struct shard_aggregate_list
+    {
+    };
+
+    // Position of a selected column, or the number of columns if it is not selected
+    template <std::size_t Index, typename Needle, typename... Columns>
+    struct shard_column_index : std::integral_constant<std::size_t, Index>
+    {
+    };
+
+    template <std::size_t Index, typename Needle, typename Column, typename... Columns>
+    struct shard_column_index<Index, Needle, Column, Columns...>
+        : std::conditional<std::is_same<Needle, Column>::value,
+                           std::integral_constant<std::size_t, Index>,
+                           shard_column_index<Index + 1, Needle, Columns...>>::type
+    {
+    };
+
+    template <typename... Ts>
+    struct shard_first_non_void
+    {
+      using type = void;
+    };
+
+    template <typename T, typename... Ts>
+    struct shard_first_non_void<T, Ts...>
+    {
+      using type = typename std::conditional<std::is_void<T>::value, shard_first_non_void<Ts...>, T>::type::type;
+    };
+
+    template <typename T>
+    struct shard_type_identity
+    {
+      using type = T;
+    };
+
+    template <typename Policy>
+    struct shard_selected_columns
+    {
+      using type = void;
+    };
+
+    template <typename Database, typename... Columns>
+    struct shard_selected_columns<select_column_list_t<Database, Columns...>>
+    {
+      using type = shard_type_identity<type_vector<Columns...>>;
+    };
+
+    template <typename Policy>
+    struct shard_order_by
+    {
+      using type = void;
+    };
+
+    template <typename Database, typename... Expressions>
+    struct shard_order_by<order_by_t<Database, Expressions...>>
+    {
+      using type = shard_type_identity<type_vector<Expressions...>>;
+    };
+
+    template <typename Policy>
+    struct shard_is_limit : std::false_type
+    {
+    };
+
+    template <typename Limit>
+    struct shard_is_limit<limit_t<Limit>> : std::true_type
+    {
+    };
+
+    // Clauses whose result cannot be computed from the shards' results
+    template <typename Policy>
+    struct shard_is_unmergeable : std::false_type
+    {
+    };
+
+    template <typename Database, typename... Expressions>
+    struct shard_is_unmergeable<group_by_t<Database, Expressions...>> : std::true_type
+    {
+    };
+
+    template <typename Database, typename Expression>
+    struct shard_is_unmergeable<having_t<Database, Expression>> : std::true_type
+    {
+    };
+
+    template <typename Offset>
+    struct shard_is_unmergeable<offset_t<Offset>> : std::true_type
+    {
+    };
+
+    template <typename Database>
+    struct shard_is_unmergeable<dynamic_offset_t<Database>> : std::true_type
+    {
+    };
+
+    template <typename Database>
+    struct shard_is_unmergeable<dynamic_limit_t<Database>> : std::true_type
+    {
+    };
+
+    // Rows might be present on several shards, dynamic flags might add distinct at runtime
+    template <typename Database, typename... Flags>
+    struct shard_is_unmergeable<select_flag_list_t<Database, Flags...>>
+        : std::integral_constant<bool,
+                                 is_database<Database>::value or
+                                     logic::any_t<std::is_same<Flags, distinct_t>::value...>::value>
+    {
+    };
+
+    template <typename Columns, typename OrderBy>
+    struct shard_merge_traits_impl;
+
+    template <typename... Columns, typename... Expressions>
+    struct shard_merge_traits_impl<type_vector<Columns...>, type_vector<sort_order_t<Expressions>...>>
+    {
+      static_assert(logic::none_t<is_multi_column_t<Columns>::value...>::value,
+                    "sharded_connection does not support multi_columns");
+      static_assert(
+          logic::all_t<(shard_column_index<0, Expressions, Columns...>::value < sizeof...(Columns))...>::value,
+                    "sharded_connection can only order by selected columns");
+      static_assert(logic::none_t<(shard_aggregate_of<Columns>::value == shard_aggregate::unsupported)...>::value,
+                    "sharded_connection cannot combine avg() or distinct aggregates over shards");
+
+      using _order_indexes = index_sequence<shard_column_index<0, Expressions, Columns...>::value...>;
+      using _aggregates = shard_aggregate_list<shard_aggregate_of<Columns>::value...>;
+      using _column_indexes = make_index_sequence<sizeof...(Columns)>;
+      static constexpr bool _is_aggregate =
+          logic::any_t<(shard_aggregate_of<Columns>::value != shard_aggregate::none)...>::value;
+
+      static_assert(not _is_aggregate or
+                        logic::all_t<(shard_aggregate_of<Columns>::value != shard_aggregate::none)...>::value,
+                    "sharded_connection cannot mix aggregates with plain columns");
+    };
+
+    template <typename Select>
+    struct shard_merge_traits;
+
+    template <typename Database, typename... Policies>
+    struct shard_merge_traits<statement_t<Database, Policies...>>
+        : public shard_merge_traits_impl<
+              typename shard_first_non_void<typename shard_selected_columns<Policies>::type...>::type,
+              typename shard_first_non_void<typename shard_order_by<Policies>::type...,
+                                            shard_type_identity<type_vector<>>>::type>
+    {
+      static_assert(logic::none_t<shard_is_unmergeable<Policies>::value...>::value,
+                    "sharded_connection cannot merge distinct, group_by, having, offset or dynamic_limit over shards");
+    };
+
+    // Sharded selects have no multi_columns, so the field index is the position in the row
+    template <std::size_t Index, typename Db, std::size_t NextIndex, std::size_t... Is, typename... FieldSpecs>
+    auto shard_field(result_row_impl<Db, field_index_sequence<NextIndex, Is...>, FieldSpecs...>& row)
+        -> result_field_t<Db, typename std::tuple_element<Index, std::tuple<FieldSpecs...>>::type>&
+    {
+      return static_cast<result_field<Db, Index, typename std::tuple_element<Index, std::tuple<FieldSpecs...>>::type>&>(
+          row)();
+    }
+
+    template <std::size_t Index, typename Db, std::size_t NextIndex, std::size_t... Is, typename... FieldSpecs>
+    auto shard_field(const result_row_impl<Db, field_index_sequence<NextIndex, Is...>, FieldSpecs...>& row)
+        -> const result_field_t<Db, typename std::tuple_element<Index, std::tuple<FieldSpecs...>>::type>&
+    {
+      return static_cast<
+          const result_field<Db, Index, typename std::tuple_element<Index, std::tuple<FieldSpecs...>>::type>&>(row)();
+    }
+
+    template <typename Field>
+    void shard_fold(Field&, const Field&, const std::integral_constant<shard_aggregate, shard_aggregate::none>&)
+    {
+    }
+
+    template <typename Field>
+    void shard_fold(Field& target,
+                    const Field& source,
+                    const std::integral_constant<shard_aggregate, shard_aggregate::sum>&)
+    {
+      if (source._is_null)
+        return;
+      if (target._is_null)
+        target._value = source._value;
+      else
+        target._value += source._value;
+      target._is_null = false;
+    }
+
+    template <typename Field>
+    void shard_fold(Field& target,
+                    const Field& source,
+                    const std::integral_constant<shard_aggregate, shard_aggregate::max>&)
+    {
+      if (not source._is_null and (target._is_null or target._value < source._value))
+      {
+        target._value = source._value;
+        target._is_null = false;
+      }
+    }
+
+    template <typename Field>
+    void shard_fold(Field& target,
+                    const Field& source,
+                    const std::integral_constant<shard_aggregate, shard_aggregate::min>&)
+    {
+      if (not source._is_null and (target._is_null or source._value < target._value))
+      {
+        target._value = source._value;
+        target._is_null = false;
+      }
+    }
+
+    // Values are compared with operator<, i.e. text bytewise
+    template <typename Field>
+    int shard_compare(const Field& lhs, const Field& rhs, sort_type order, null_order nulls)
+    {
+      const int null_result = nulls == null_order::smallest ? -1 : 1;
+      const int result = lhs._is_null ? (rhs._is_null ? 0 : null_result)
+                                      : rhs._is_null ? -null_result
+                                                     : (lhs._value < rhs._value ? -1 : rhs._value < lhs._value ? 1 : 0);
+      return order == sort_type::asc ? result : -result;
+    }
+
+    template <typename Expressions, std::size_t... Is>
+    std::vector<sort_type> shard_sort_types_of(const Expressions& expressions, const index_sequence<Is...>&)
+    {
+      return {std::get<Is>(expressions)._sort_type...};
+    }
+
+    template <typename Select>
+    auto shard_sort_types(const Select& s, int) -> decltype(s.order_by._data._expressions, std::vector<sort_type>())
+    {
+      if (not s.order_by._data._dynamic_expressions.empty())
+        throw sqlpp::exception("sharded_connection cannot merge by dynamic order_by expressions");
+      using _expressions_t = decltype(s.order_by._data._expressions);
+      return shard_sort_types_of(s.order_by._data._expressions,
+                                 make_index_sequence<std::tuple_size<_expressions_t>::value>{});
+    }
+
+    template <typename Select>
+    std::vector<sort_type> shard_sort_types(const Select&, long)
+    {
+      return {};
+    }
+
+    template <typename Select>
+    auto shard_limit(const Select& s, int) -> decltype(s.limit._data._value._t, std::size_t())
+    {
+      return s.limit._data._value._t < 0 ? 0 : static_cast<std::size_t>(s.limit._data._value._t);
+    }
+
+    template <typename Select>
+    std::size_t shard_limit(const Select&, long)
+    {
+      return std::numeric_limits<std::size_t>::max();
+    }
+
+    // Plays the role of the connector's result for result_t: Each call to next() takes the next row from one
+    // of the shards (in the order of the order_by expressions, or shard by shard), or combines the aggregates.
+    template <typename ShardResult, typename ResultRow, typename MergeTraits>
+    class sharded_result_t
+    {
+      std::vector<ShardResult> _shards;
+      std::vector<ResultRow> _heads;
+      std::vector<sort_type> _sort_types;
+      null_order _nulls = null_order::smallest;
+      std::size_t _remaining = 0;
+      std::size_t _current = 0;
+      bool _started = false;
+
+      template <typename Field>
+      int _compare_field(const Field& lhs, const Field& rhs, std::size_t order) const
+      {
+        return shard_compare(lhs, rhs, _sort_types[order], _nulls);
+      }
+
+      template <std::size_t... Is>
+      int _compare(const ResultRow& lhs, const ResultRow& rhs, const index_sequence<Is...>&) const
+      {
+        int result = 0;
+        std::size_t order = 0;
+        using swallow = int[];
+        (void)swallow{0, (result = result ? result : _compare_field(shard_field<Is>(lhs), shard_field<Is>(rhs), order),
+                          ++order,
+                          0)...};
+        return result;
+      }
+
+      template <shard_aggregate... Aggregates, std::size_t... Is>
+      static void _fold(ResultRow& target,
+                        const ResultRow& source,
+                        const shard_aggregate_list<Aggregates...>&,
+                        const index_sequence<Is...>&)
+      {
+        using swallow = int[];
+        (void)swallow{0, (shard_fold(shard_field<Is>(target), shard_field<Is>(source),
+                                     std::integral_constant<shard_aggregate, Aggregates>{}),
+                          0)...};
+      }
+
+      std::size_t _next_shard()
+      {
+        if (_sort_types.empty())
+        {
+          while (_current < _heads.size() and not _heads[_current])
+            ++_current;
+          return _current;
+        }
+        auto shard = _heads.size();
+        for (std::size_t i = 0; i < _heads.size(); ++i)
+        {
+          if (_heads[i] and
+              (shard == _heads.size() or
+               _compare(_heads[i], _heads[shard], typename MergeTraits::_order_indexes{}) < 0))
+            shard = i;
+        }
+        return shard;
+      }
+
+      void _next(ResultRow& target, const std::false_type& /* is aggregate */)
+      {
+        const auto shard = _next_shard();
+        if (shard == _heads.size())
+        {
+          target._invalidate();
+          return;
+        }
+        std::swap(target, _heads[shard]);
+        _shards[shard].next(_heads[shard]);
+        --_remaining;
+      }
+
+      void _next(ResultRow& target, const std::true_type& /* is aggregate */)
+      {
+        target._invalidate();
+        for (auto& head : _heads)
+        {
+          if (not head)
+            continue;
+          if (target)
+            _fold(target, head, typename MergeTraits::_aggregates{}, typename MergeTraits::_column_indexes{});
+          else
+            std::swap(target, head);
+        }
+        _remaining = 0;
+      }
+
+    public:
+      sharded_result_t() = default;
+
+      template <typename DynamicNames>
+      sharded_result_t(std::vector<ShardResult> shards,
+                       const DynamicNames& dynamic_names,
+                       std::vector<sort_type> sort_types,
+                       null_order nulls,
+                       std::size_t limit)
+          : _shards(std::move(shards)), _sort_types(std::move(sort_types)), _nulls(nulls), _remaining(limit)
+      {
+        _heads.reserve(_shards.size());
+        for (std::size_t i = 0; i < _shards.size(); ++i)
+        {
+          _heads.emplace_back(dynamic_names);
+        }
+      }
+
+      sharded_result_t(const sharded_result_t&) = delete;
+      sharded_result_t(sharded_result_t&&) = default;
+      sharded_result_t& operator=(const sharded_result_t&) = delete;
+      sharded_result_t& operator=(sharded_result_t&&) = default;
+      ~sharded_result_t() = default;
+
+      void next(ResultRow& target)
+      {
+        // The rows are read only after the result has been moved to its final place
+        if (not _started)
+        {
+          _started = true;
+          for (std::size_t i = 0; i < _shards.size(); ++i)
+          {
+            _shards[i].next(_heads[i]);
+          }
+        }
+        if (_remaining == 0)
+        {
+          target._invalidate();
+          return;
+        }
+        _next(target, std::integral_constant<bool, MergeTraits::_is_aggregate>{});
+      }
+    };
+  }
+
+  // Runs selects on all shards (in parallel with the executor of the config) and merges the results into one typed
+  // result:
+  //  - with order_by, the rows are merged in the order of the (selected) order_by columns, assuming that the shards
+  //    sort NULL as configured and text in binary collation (bytewise),
+  //  - a limit is applied to the merged rows,
+  //  - count(), sum(), max() and min() are combined into a single row (the select must not have other columns),
+  //  - otherwise the rows are returned shard by shard.
+  // Statements that cannot be merged (distinct, group_by, having, offset, avg, distinct aggregates) are rejected at
+  // compile time.
+  // Other statements are executed on one of the shards, see shard().
+  // The connections are not owned and must outlive the sharded_connection.
+  template <typename Db>
+  class sharded_connection : public sqlpp::connection
+  {
+    std::vector<Db*> _shards;
+    sharded_config_t _config;
+
+    template <typename Select>
+    using _shard_result_t = decltype(std::declval<Db&>().select(std::declval<const Select&>()));
+
+    template <typename Select>
+    using _result_row_t = typename Select::template _result_row_t<Db>;
+
+    template <typename Select>
+    using _merged_result_t = detail::
+        sharded_result_t<_shard_result_t<Select>, _result_row_t<Select>, detail::shard_merge_traits<Select>>;
+
+    template <typename Select>
+    std::vector<_shard_result_t<Select>> _scatter(const Select& s)
+    {
+      const auto shard_count = _shards.size();
+      std::vector<_shard_result_t<Select>> results(shard_count);
+      std::vector<std::exception_ptr> errors(shard_count);
+      auto run = [this, &s, &results, &errors](std::size_t i)
+      {
+        try
+        {
+          results[i] = _shards[i]->select(s);
+        }
+        catch (...)
+        {
+          errors[i] = std::current_exception();
+        }
+      };
+
+      if (_config.executor)
+      {
+        // The tasks refer to the state of this function, so it must not be left before they are done
+        std::mutex mutex;
+        std::condition_variable done;
+        std::size_t pending = 0;
+        auto wait = [&mutex, &done, &pending]()
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          done.wait(lock, [&pending]() { return pending == 0; });
+        };
+        try
+        {
+          for (std::size_t i = 1; i < shard_count; ++i)
+          {
+            {
+              std::lock_guard<std::mutex> lock(mutex);
+              ++pending;
+            }
+            try
+            {
+              _config.executor([&run, &mutex, &done, &pending, i]()
+                               {
+                                 run(i);
+                                 std::lock_guard<std::mutex> lock(mutex);
+                                 --pending;
+                                 done.notify_all();
+                               });
+            }
+            catch (...)
+            {
+              std::lock_guard<std::mutex> lock(mutex);
+              --pending;
+              throw;
+            }
+          }
+        }
+        catch (...)
+        {
+          wait();
+          throw;
+        }
+        run(0);
+        wait();
+      }
+      else
+      {
+        for (std::size_t i = 0; i < shard_count; ++i)
+        {
+          run(i);
+        }
+      }
+
+      for (const auto& error : errors)
+      {
+        if (error)
+          std::rethrow_exception(error);
+      }
+      return results;
+    }
+
+  public:
+    using _traits = typename Db::_traits;
+    using _serializer_context_t = typename Db::_serializer_context_t;
+    using _interpreter_context_t = typename Db::_interpreter_context_t;
+
+    sharded_connection(std::vector<Db*> shards, sharded_config_t config = {})
+        : _shards(std::move(shards)), _config(std::move(config))
+    {
+      if (_shards.empty())
+        throw sqlpp::exception("sharded_connection: at least one shard is required");
+      for (const auto shard : _shards)
+      {
+        if (not shard)
+          throw sqlpp::exception("sharded_connection: shard must not be null");
+      }
+    }
+
+    sharded_connection(const sharded_connection&) = delete;
+    sharded_connection(sharded_connection&&) = delete;
+    sharded_connection& operator=(const sharded_connection&) = delete;
+    sharded_connection& operator=(sharded_connection&&) = delete;
+    ~sharded_connection() = default;
+
+    template <typename T>
+    static _serializer_context_t& _serialize_interpretable(const T& t, _serializer_context_t& context)
+    {
+      return Db::_serialize_interpretable(t, context);
+    }
+
+    template <typename T>
+    static _interpreter_context_t& _interpret_interpretable(const T& t, _interpreter_context_t& context)
+    {
+      return Db::_interpret_interpretable(t, context);
+    }
+
+    std::size_t size() const
+    {
+      return _shards.size();
+    }
+
+    Db& shard(std::size_t index)
+    {
+      return *_shards.at(index);
+    }
+
+    template <typename Select>
+    auto operator()(const Select& s) -> result_t<_merged_result_t<Select>, _result_row_t<Select>>
+    {
+      static_assert(has_result_row_t<Select>::value, "sharded_connection can only run selects, see shard()");
+      using _run_check = run_check_t<_serializer_context_t, Select>;
+      _run_check{};
+
+      if (detail::shard_merge_traits<Select>::_is_aggregate and
+          not s.get_selected_columns()._data._dynamic_columns.empty())
+        throw sqlpp::exception("sharded_connection cannot combine dynamic columns with aggregates");
+
+      return {_merged_result_t<Select>{_scatter(s), s.get_dynamic_names(), detail::shard_sort_types(s, 0),
+                                       _config.nulls, detail::shard_limit(s, 0)},
+              s.get_dynamic_names()};
+    }
+  };
+}
+
+#endif
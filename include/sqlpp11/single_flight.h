@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_SINGLE_FLIGHT_H
+#define SQLPP_SINGLE_FLIGHT_H
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sqlpp11/connection_pool.h>
+#include <sqlpp11/fingerprint.h>
+#include <sqlpp11/materialized_result.h>
+#include <sqlpp11/serialize.h>
+#include <sqlpp11/serializer_context.h>
+#include <sqlpp11/type_traits.h>
+
+namespace sqlpp
+{
+  struct single_flight_metrics_t
+  {
+    std::size_t queries;    // selects sent to the database
+    std::size_t coalesced;  // selects that waited for an identical select instead
+  };
+
+  // Runs selects on connections of the pool. If an identical select (same serialized SQL, including all values) is
+  // already running, the caller waits for its rows instead of sending another query. All callers get
+  // materialized results sharing the same immutable rows. If the query fails, all waiting callers get the exception.
+  // Only complete, directly executable selects are coalesced: Prepared statements belong to a single connection and
+  // are rejected at compile time, as are selects with parameter() (use values instead, they are part of the key).
+  // Thread safe.
+  template <typename Connection>
+  class single_flight
+  {
+    using _rows_t = std::shared_ptr<const void>;
+
+    struct _flight_t
+    {
+      std::size_t _row_type;
+      std::shared_future<_rows_t> _rows;
+    };
+
+    connection_pool<Connection>& _pool;
+    std::mutex _mutex;
+    std::unordered_map<std::string, _flight_t> _flights;
+    std::atomic<std::size_t> _queries{0};
+    std::atomic<std::size_t> _coalesced{0};
+
+    template <typename Select>
+    using _result_row_t = typename Select::template _result_row_t<Connection>;
+
+    void _land(const std::string& key)
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _flights.erase(key);
+    }
+
+  public:
+    single_flight(connection_pool<Connection>& pool) : _pool(pool)
+    {
+    }
+
+    single_flight(const single_flight&) = delete;
+    single_flight(single_flight&&) = delete;
+    single_flight& operator=(const single_flight&) = delete;
+    single_flight& operator=(single_flight&&) = delete;
+    ~single_flight() = default;
+
+    template <typename Select>
+    auto operator()(const Select& s) -> materialized_result_t<_result_row_t<Select>>
+    {
+      static_assert(is_statement_t<Select>::value and has_result_row_t<Select>::value,
+                    "single_flight can only run selects (not prepared selects)");
+      using _row_t = _result_row_t<Select>;
+      using _db_result_t = detail::materialized_db_result_t<_row_t>;
+
+      std::ostringstream os;
+      serializer_context_t context{os};
+      serialize(s, context);
+      const auto key = os.str();
+
+      std::promise<_rows_t> promise;
+      std::shared_future<_rows_t> flight;
+      auto is_leader = false;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto it = _flights.find(key);
+        if (it == _flights.end())
+        {
+          flight = promise.get_future().share();
+          _flights.emplace(key, _flight_t{detail::type_id<_row_t>(), flight});
+          is_leader = true;
+        }
+        else if (it->second._row_type == detail::type_id<_row_t>())
+          flight = it->second._rows;
+        // otherwise the same SQL yields a different row type (e.g. different database types), run it separately
+      }
+
+      if (flight.valid() and not is_leader)
+      {
+        ++_coalesced;
+        return {_db_result_t{std::static_pointer_cast<const std::vector<_row_t>>(flight.get())}, s.get_dynamic_names()};
+      }
+
+      ++_queries;
+      std::shared_ptr<const std::vector<_row_t>> rows;
+      try
+      {
+        auto lease = _pool.acquire();
+        rows = detail::materialize_rows(*lease, s);
+      }
+      catch (...)
+      {
+        if (is_leader)
+        {
+          _land(key);
+          promise.set_exception(std::current_exception());
+        }
+        throw;
+      }
+      if (is_leader)
+      {
+        // later callers start a new flight and thus see newer data
+        _land(key);
+        promise.set_value(rows);
+      }
+      return {_db_result_t{std::move(rows)}, s.get_dynamic_names()};
+    }
+
+    single_flight_metrics_t metrics() const
+    {
+      return {_queries.load(), _coalesced.load()};
+    }
+  };
+}
+
+#endif
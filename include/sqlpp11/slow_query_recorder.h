@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SQLPP_SLOW_QUERY_RECORDER_H
+#define SQLPP_SLOW_QUERY_RECORDER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sqlpp11/chrono.h>
+#include <sqlpp11/exception.h>
+#include <sqlpp11/explain.h>
+
+namespace sqlpp
+{
+  struct slow_query_t
+  {
+    using duration = std::chrono::nanoseconds;
+
+    // See statement_shape(), empty for strings
+    std::string shape;
+    // For prepared statements, the text they were prepared from (with placeholders)
+    std::string sql;
+    // Bound values of prepared statements, in order of the placeholders
+    bound_values_t parameters;
+    // Serialization, execution and fetching the first row (for selects)
+    duration elapsed = duration::zero();
+    // Empty if the connector cannot explain the statement
+    explain_plan_t plan;
+    // Why the plan is missing, e.g. the error reported by the connector
+    std::string explain_error;
+    bool failed = false;
+    std::chrono::system_clock::time_point recorded_at;
+  };
+
+  // Keeps the most recent slow queries (those that took longer than the threshold) in a ring of fixed capacity.
+  // Recording and reading may happen from any number of threads.
+  class slow_query_recorder_t
+  {
+  public:
+    using duration = slow_query_t::duration;
+
+    slow_query_recorder_t(duration threshold, std::size_t capacity = 64) : _threshold(threshold), _capacity(capacity)
+    {
+      if (capacity == 0)
+        throw sqlpp::exception("slow_query_recorder_t: capacity must not be zero");
+      _ring.reserve(capacity);
+    }
+
+    slow_query_recorder_t(const slow_query_recorder_t&) = delete;
+    slow_query_recorder_t(slow_query_recorder_t&&) = delete;
+    slow_query_recorder_t& operator=(const slow_query_recorder_t&) = delete;
+    slow_query_recorder_t& operator=(slow_query_recorder_t&&) = delete;
+    ~slow_query_recorder_t() = default;
+
+    duration threshold() const
+    {
+      return _threshold;
+    }
+
+    std::size_t capacity() const
+    {
+      return _capacity;
+    }
+
+    bool is_slow(duration elapsed) const
+    {
+      return elapsed > _threshold;
+    }
+
+    // Replaces the oldest entry once the capacity is reached
+    void record(slow_query_t query)
+    {
+      query.recorded_at = std::chrono::system_clock::now();
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_ring.size() < _capacity)
+        _ring.push_back(std::move(query));
+      else
+        _ring[_next] = std::move(query);
+      _next = (_next + 1) % _capacity;
+      ++_recorded;
+    }
+
+    // Including the entries that have been replaced since
+    std::uint64_t recorded() const
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _recorded;
+    }
+
+    // Oldest first
+    std::vector<slow_query_t> snapshot() const
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      std::vector<slow_query_t> queries;
+      queries.reserve(_ring.size());
+      const auto first = _ring.size() < _capacity ? 0 : _next;
+      for (std::size_t i = 0; i < _ring.size(); ++i)
+      {
+        queries.push_back(_ring[(first + i) % _ring.size()]);
+      }
+      return queries;
+    }
+
+    void clear()
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _ring.clear();
+      _next = 0;
+    }
+
+    // One block per query, oldest first, e.g.
+    //   shape="select tab_bar" elapsed_us=1520.3 failed=0
+    //   sql: SELECT tab_bar.alpha FROM tab_bar WHERE (tab_bar.alpha=?)
+    //   parameter: 7
+    //   plan: SCAN TABLE tab_bar
+    // Text parameters are quoted like SQL literals, e.g. 'O''Brien', null values are printed as NULL.
+    std::string to_text() const
+    {
+      std::ostringstream os;
+      os << std::fixed << std::setprecision(1);
+      for (const auto& query : snapshot())
+      {
+        os << "shape=\"" << query.shape << "\" elapsed_us=" << query.elapsed.count() / 1000.0
+           << " failed=" << query.failed << '\n';
+        os << "sql: " << query.sql << '\n';
+        for (const auto& parameter : query.parameters)
+        {
+          os << "parameter: ";
+          _print(os, parameter);
+          os << '\n';
+        }
+        for (const auto& row : query.plan)
+        {
+          os << "plan: " << row << '\n';
+        }
+        if (not query.explain_error.empty())
+          os << "explain_error: " << query.explain_error << '\n';
+      }
+      return os.str();
+    }
+
+  private:
+    static void _print(std::ostream& os, const bound_value_t& parameter)
+    {
+      if (parameter.is_null)
+      {
+        os << "NULL";
+        return;
+      }
+      if (not parameter.is_text)
+      {
+        os << parameter.text;
+        return;
+      }
+      os << '\'';
+      for (const auto c : parameter.text)
+      {
+        if (c == '\'')
+          os << '\'';
+        os << c;
+      }
+      os << '\'';
+    }
+
+    const duration _threshold;
+    const std::size_t _capacity;
+    mutable std::mutex _mutex;
+    std::vector<slow_query_t> _ring;
+    std::size_t _next = 0;
+    std::uint64_t _recorded = 0;
+  };
+
+  namespace detail
+  {
+    // Binding target for parameter lists that renders the raw values as text
+    struct parameter_value_collector_t
+    {
+      bound_values_t values;
+
+      template <typename T>
+      void _bind_boolean_parameter(std::size_t index, const T* value, bool is_null)
+      {
+        _set(index, is_null, [&](std::ostream& os) { os << (*value ? "true" : "false"); });
+      }
+
+      template <typename T>
+      void _bind_integral_parameter(std::size_t index, const T* value, bool is_null)
+      {
+        _set(index, is_null, [&](std::ostream& os) { os << *value; });
+      }
+
+      template <typename T>
+      void _bind_unsigned_integral_parameter(std::size_t index, const T* value, bool is_null)
+      {
+        _set(index, is_null, [&](std::ostream& os) { os << *value; });
+      }
+
+      template <typename T>
+      void _bind_floating_point_parameter(std::size_t index, const T* value, bool is_null)
+      {
+        _set(index, is_null, [&](std::ostream& os) { os << std::setprecision(17) << *value; });
+      }
+
+      template <typename T>
+      void _bind_text_parameter(std::size_t index, const T* value, bool is_null)
+      {
+        _set(index, is_null, [&](std::ostream& os) { os << *value; });
+        values[index].is_text = true;
+      }
+
+      template <typename T>
+      void _bind_date_parameter(std::size_t index, const T* value, bool is_null)
+      {
+        _set(index, is_null, [&](std::ostream& os) { os << ::date::year_month_day{*value}; });
+      }
+
+      template <typename T>
+      void _bind_date_time_parameter(std::size_t index, const T* value, bool is_null)
+      {
+        _set(index, is_null, [&](std::ostream& os)
+             {
+               const auto dp = ::sqlpp::chrono::floor<::date::days>(*value);
+               os << ::date::year_month_day{dp} << ' ' << ::date::make_time(*value - dp);
+             });
+      }
+
+      template <typename T>
+      void _bind_time_of_day_parameter(std::size_t index, const T* value, bool is_null)
+      {
+        _set(index, is_null, [&](std::ostream& os) { os << ::date::make_time(*value); });
+      }
+
+    private:
+      template <typename Print>
+      void _set(std::size_t index, bool is_null, Print print)
+      {
+        if (values.size() <= index)
+          values.resize(index + 1);
+        auto& value = values[index];
+        value.is_null = is_null;
+        if (is_null)
+          return;
+        std::ostringstream os;
+        print(os);
+        value.text = os.str();
+      }
+    };
+
+    template <typename ParameterList>
+    bound_values_t parameter_values(const ParameterList& params)
+    {
+      parameter_value_collector_t collector;
+      params._bind(collector);
+      return std::move(collector.values);
+    }
+  }
+}
+
+#endif
@@ -27,6 +27,7 @@
 #ifndef SQLPP_STATEMENT_H
 #define SQLPP_STATEMENT_H
 
+#include <sqlpp11/arena.h>
 #include <sqlpp11/noop.h>
 #include <sqlpp11/parameter_list.h>
 #include <sqlpp11/policy_update.h>
@@ -244,6 +245,15 @@ namespace sqlpp
       _prepare_check{};  // FIXME: Dispatch?
       return _result_methods_t<statement_t>::_prepare(db);
     }
+
+    // see with_arena()
+    void _use_arena(arena_t* arena)
+    {
+      using swallow = int[];
+      (void)swallow{
+          0, (detail::use_arena(static_cast<typename Policies::template _base_t<_policies_t>&>(*this)()._data, arena),
+              0)...};
+    }
   };
 
   template <typename Context, typename Database, typename... Policies>
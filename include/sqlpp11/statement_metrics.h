@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_STATEMENT_METRICS_H
+#define SQLPP_STATEMENT_METRICS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sqlpp11/exception.h>
+#include <sqlpp11/fingerprint.h>
+#include <sqlpp11/instrumented.h>
+#include <sqlpp11/statement_shape.h>
+
+namespace sqlpp
+{
+  namespace detail
+  {
+    inline unsigned highest_bit(std::uint64_t value)
+    {
+      unsigned bit = 0;
+      for (unsigned shift = 32; shift > 0; shift /= 2)
+      {
+        if (value >> shift)
+        {
+          value >>= shift;
+          bit += shift;
+        }
+      }
+      return bit;
+    }
+  }
+
+  // HDR-style latency histogram: Buckets are linear within each power of two, so that every recorded value is
+  // off by at most 1/32 (about 3%). Values range from 1ns to about 18 minutes, larger values are clamped.
+  // Recording is lock-free and may happen from any number of threads while others read.
+  class latency_histogram_t
+  {
+  public:
+    using duration = std::chrono::nanoseconds;
+
+    static constexpr unsigned _sub_bucket_bits = 5;
+    static constexpr std::uint64_t _sub_bucket_count = std::uint64_t{1} << _sub_bucket_bits;
+    static constexpr unsigned _max_bits = 40;
+    static constexpr std::uint64_t _max_value = (std::uint64_t{1} << _max_bits) - 1;
+    static constexpr std::size_t _bucket_count = (_max_bits - _sub_bucket_bits + 1) * _sub_bucket_count;
+
+    latency_histogram_t()
+    {
+      for (auto& count : _counts)
+      {
+        count.store(0, std::memory_order_relaxed);
+      }
+    }
+
+    latency_histogram_t(const latency_histogram_t&) = delete;
+    latency_histogram_t(latency_histogram_t&&) = delete;
+    latency_histogram_t& operator=(const latency_histogram_t&) = delete;
+    latency_histogram_t& operator=(latency_histogram_t&&) = delete;
+    ~latency_histogram_t() = default;
+
+    static std::size_t _index(std::uint64_t value)
+    {
+      if (value < 2 * _sub_bucket_count)
+        return static_cast<std::size_t>(value);
+      const auto shift = detail::highest_bit(value) - _sub_bucket_bits;
+      return static_cast<std::size_t>((shift + 1) * _sub_bucket_count + (value >> shift) - _sub_bucket_count);
+    }
+
+    // The largest value that is recorded in the bucket
+    static std::uint64_t _highest_value(std::size_t index)
+    {
+      if (index < 2 * _sub_bucket_count)
+        return index;
+      const auto shift = index / _sub_bucket_count - 1;
+      const auto sub_bucket = index % _sub_bucket_count + _sub_bucket_count;
+      return ((sub_bucket + 1) << shift) - 1;
+    }
+
+    void record(duration latency)
+    {
+      const auto value = std::min(static_cast<std::uint64_t>(std::max<duration::rep>(latency.count(), 0)),
+                                  std::uint64_t{_max_value});
+      _counts[_index(value)].fetch_add(1, std::memory_order_relaxed);
+      _count.fetch_add(1, std::memory_order_relaxed);
+      _sum.fetch_add(value, std::memory_order_relaxed);
+      auto max = _max.load(std::memory_order_relaxed);
+      while (value > max and not _max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    std::uint64_t count() const
+    {
+      return _count.load(std::memory_order_relaxed);
+    }
+
+    duration max() const
+    {
+      return duration{static_cast<duration::rep>(_max.load(std::memory_order_relaxed))};
+    }
+
+    duration mean() const
+    {
+      const auto n = count();
+      return duration{n ? static_cast<duration::rep>(_sum.load(std::memory_order_relaxed) / n) : 0};
+    }
+
+    // The latency that the given percentage (e.g. 99.9) of the recorded values do not exceed
+    duration percentile(double percent) const
+    {
+      std::uint64_t total = 0;
+      std::array<std::uint64_t, _bucket_count> counts;
+      for (std::size_t i = 0; i < _bucket_count; ++i)
+      {
+        counts[i] = _counts[i].load(std::memory_order_relaxed);
+        total += counts[i];
+      }
+      if (total == 0)
+        return duration::zero();
+
+      const auto fraction = std::min(std::max(percent, 0.0), 100.0) / 100.0;
+      const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(fraction * total + 0.5));
+      std::uint64_t seen = 0;
+      for (std::size_t i = 0; i < _bucket_count; ++i)
+      {
+        seen += counts[i];
+        if (seen >= rank)
+          return std::min(duration{static_cast<duration::rep>(_highest_value(i))}, max());
+      }
+      return max();
+    }
+
+  private:
+    std::array<std::atomic<std::uint64_t>, _bucket_count> _counts;
+    std::atomic<std::uint64_t> _count{0};
+    std::atomic<std::uint64_t> _sum{0};
+    std::atomic<std::uint64_t> _max{0};
+  };
+
+  struct statement_metrics_t
+  {
+    statement_metrics_t(const statement_shape_t& shape_) : shape(shape_)
+    {
+    }
+
+    const statement_shape_t& shape;
+    latency_histogram_t latency;
+    std::atomic<std::uint64_t> failures{0};
+    std::atomic<std::uint64_t> rows{0};
+
+    void record(latency_histogram_t::duration duration, std::size_t row_count, bool failed)
+    {
+      latency.record(duration);
+      rows.fetch_add(row_count, std::memory_order_relaxed);
+      if (failed)
+        failures.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+
+  struct statement_metrics_snapshot_t
+  {
+    using duration = latency_histogram_t::duration;
+
+    std::string shape;
+    std::uint64_t calls = 0;
+    std::uint64_t failures = 0;
+    std::uint64_t rows = 0;
+    duration mean = duration::zero();
+    duration p50 = duration::zero();
+    duration p90 = duration::zero();
+    duration p99 = duration::zero();
+    duration p999 = duration::zero();
+    duration max = duration::zero();
+  };
+
+  // Metrics per statement shape. Shapes are added on first use (one allocation), after that, looking up and
+  // recording is lock-free. Shapes are never removed, their number is limited by the capacity.
+  // Shapes are referenced, not copied, see statement_shape().
+  class statement_metrics_registry_t
+  {
+    std::vector<std::atomic<statement_metrics_t*>> _slots;
+
+    std::size_t _mask() const
+    {
+      return _slots.size() - 1;
+    }
+
+  public:
+    statement_metrics_registry_t(std::size_t max_shapes = 512)
+        : _slots([max_shapes]
+                 {
+                   std::size_t size = 2;
+                   while (size < 2 * max_shapes)
+                     size *= 2;
+                   return size;
+                 }())
+    {
+      for (auto& slot : _slots)
+      {
+        slot.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    statement_metrics_registry_t(const statement_metrics_registry_t&) = delete;
+    statement_metrics_registry_t(statement_metrics_registry_t&&) = delete;
+    statement_metrics_registry_t& operator=(const statement_metrics_registry_t&) = delete;
+    statement_metrics_registry_t& operator=(statement_metrics_registry_t&&) = delete;
+
+    ~statement_metrics_registry_t()
+    {
+      for (auto& slot : _slots)
+      {
+        delete slot.load(std::memory_order_relaxed);
+      }
+    }
+
+    statement_metrics_t& at(const statement_shape_t& shape)
+    {
+      statement_metrics_t* created = nullptr;
+      for (std::size_t probe = 0, i = detail::hash_combine(0, shape.id) & _mask(); probe < _slots.size();
+           ++probe, i = (i + 1) & _mask())
+      {
+        auto metrics = _slots[i].load(std::memory_order_acquire);
+        if (not metrics)
+        {
+          if (not created)
+            created = new statement_metrics_t(shape);
+          if (_slots[i].compare_exchange_strong(metrics, created, std::memory_order_acq_rel))
+            return *created;
+        }
+        if (metrics->shape.id == shape.id)
+        {
+          delete created;
+          return *metrics;
+        }
+      }
+      delete created;
+      throw sqlpp::exception("statement_metrics_registry_t: too many statement shapes");
+    }
+
+    template <typename Statement>
+    statement_metrics_t& at()
+    {
+      return at(statement_shape<Statement>());
+    }
+
+    // Shapes sorted by name
+    std::vector<statement_metrics_snapshot_t> snapshot() const
+    {
+      std::vector<statement_metrics_snapshot_t> snapshots;
+      for (const auto& slot : _slots)
+      {
+        const auto metrics = slot.load(std::memory_order_acquire);
+        if (not metrics)
+          continue;
+        statement_metrics_snapshot_t snapshot;
+        snapshot.shape = metrics->shape.name;
+        snapshot.calls = metrics->latency.count();
+        snapshot.failures = metrics->failures.load(std::memory_order_relaxed);
+        snapshot.rows = metrics->rows.load(std::memory_order_relaxed);
+        snapshot.mean = metrics->latency.mean();
+        snapshot.p50 = metrics->latency.percentile(50.0);
+        snapshot.p90 = metrics->latency.percentile(90.0);
+        snapshot.p99 = metrics->latency.percentile(99.0);
+        snapshot.p999 = metrics->latency.percentile(99.9);
+        snapshot.max = metrics->latency.max();
+        snapshots.push_back(snapshot);
+      }
+      std::sort(snapshots.begin(), snapshots.end(),
+                [](const statement_metrics_snapshot_t& lhs, const statement_metrics_snapshot_t& rhs)
+                { return lhs.shape < rhs.shape; });
+      return snapshots;
+    }
+
+    // One line per shape, latencies in microseconds, e.g.
+    //   shape="select tab_bar" calls=12 failures=0 rows=36 mean_us=80.2 p50_us=75.0 ...
+    std::string to_text() const
+    {
+      const auto us = [](statement_metrics_snapshot_t::duration d) { return d.count() / 1000.0; };
+      std::ostringstream os;
+      os << std::fixed << std::setprecision(1);
+      for (const auto& snapshot : snapshot())
+      {
+        os << "shape=\"" << snapshot.shape << "\" calls=" << snapshot.calls << " failures=" << snapshot.failures
+           << " rows=" << snapshot.rows << " mean_us=" << us(snapshot.mean) << " p50_us=" << us(snapshot.p50)
+           << " p90_us=" << us(snapshot.p90) << " p99_us=" << us(snapshot.p99) << " p999_us=" << us(snapshot.p999)
+           << " max_us=" << us(snapshot.max) << '\n';
+      }
+      return os.str();
+    }
+  };
+
+  // A sink for instrumented<Db> that records the latency of statements (not of transaction calls and strings)
+  inline instrumentation_sink_t record_to(statement_metrics_registry_t& registry)
+  {
+    return [&registry](const execution_timing_t& timing)
+    {
+      if (timing.shape)
+        registry.at(*timing.shape)
+            .record(timing.serialization + std::max(timing.execution, timing.first_row), timing.rows, timing.failed);
+    };
+  }
+}
+
+#endif
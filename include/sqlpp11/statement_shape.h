@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_STATEMENT_SHAPE_H
+#define SQLPP_STATEMENT_SHAPE_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+#include <sqlpp11/fingerprint.h>
+#include <sqlpp11/insert.h>
+#include <sqlpp11/prepared_execute.h>
+#include <sqlpp11/prepared_insert.h>
+#include <sqlpp11/prepared_remove.h>
+#include <sqlpp11/prepared_select.h>
+#include <sqlpp11/prepared_update.h>
+#include <sqlpp11/remove.h>
+#include <sqlpp11/select.h>
+#include <sqlpp11/statement.h>
+#include <sqlpp11/table_alias.h>
+#include <sqlpp11/type_traits.h>
+#include <sqlpp11/update.h>
+#include <sqlpp11/detail/type_set.h>
+#include <sqlpp11/detail/void.h>
+
+namespace sqlpp
+{
+  namespace detail
+  {
+    // The raw tables used anywhere in the static parts of a statement (including sub-selects)
+    template <typename T>
+    struct tables_of;
+
+    template <typename Nodes>
+    struct tables_of_nodes;
+
+    template <typename... Nodes>
+    struct tables_of_nodes<type_vector<Nodes...>>
+    {
+      using type = make_joined_set_t<typename tables_of<Nodes>::type...>;
+    };
+
+    template <typename T, typename Enable = void>
+    struct tables_of_impl
+    {
+      using type = type_set<>;
+    };
+
+    template <typename T>
+    struct tables_of_impl<T, void_t<typename T::_nodes>>
+    {
+      using type = typename std::conditional<is_raw_table_t<T>::value,
+                                             type_set<T>,
+                                             typename tables_of_nodes<typename T::_nodes>::type>::type;
+    };
+
+    template <typename T>
+    struct tables_of
+    {
+      using type = typename tables_of_impl<T>::type;
+    };
+
+    template <typename Db, typename... Policies>
+    struct tables_of<statement_t<Db, Policies...>>
+    {
+      using type = make_joined_set_t<typename tables_of<Policies>::type...>;
+    };
+
+    template <typename Table, typename ColumnSpec>
+    struct tables_of<column_t<Table, ColumnSpec>>
+    {
+      using type = typename tables_of<Table>::type;
+    };
+
+    template <typename AliasProvider, typename Table, typename... ColumnSpec>
+    struct tables_of<table_alias_t<AliasProvider, Table, ColumnSpec...>>
+    {
+      using type = typename tables_of<Table>::type;
+    };
+
+    // Prepared statements have the shape (and tables) of the statement they were prepared from
+    template <typename T>
+    struct shape_statement_of
+    {
+      using type = T;
+    };
+
+    template <typename Database, typename Statement, typename Composite>
+    struct shape_statement_of<prepared_select_t<Database, Statement, Composite>>
+    {
+      using type = Statement;
+    };
+
+    template <typename Db, typename Statement>
+    struct shape_statement_of<prepared_insert_t<Db, Statement>>
+    {
+      using type = Statement;
+    };
+
+    template <typename Db, typename Statement>
+    struct shape_statement_of<prepared_update_t<Db, Statement>>
+    {
+      using type = Statement;
+    };
+
+    template <typename Db, typename Statement>
+    struct shape_statement_of<prepared_remove_t<Db, Statement>>
+    {
+      using type = Statement;
+    };
+
+    template <typename Db, typename Statement>
+    struct shape_statement_of<prepared_execute_t<Db, Statement>>
+    {
+      using type = Statement;
+    };
+
+    template <typename Database, typename Statement, typename Composite>
+    struct tables_of<prepared_select_t<Database, Statement, Composite>>
+    {
+      using type = typename tables_of<Statement>::type;
+    };
+
+    template <typename Db, typename Statement>
+    struct tables_of<prepared_insert_t<Db, Statement>>
+    {
+      using type = typename tables_of<Statement>::type;
+    };
+
+    template <typename Db, typename Statement>
+    struct tables_of<prepared_update_t<Db, Statement>>
+    {
+      using type = typename tables_of<Statement>::type;
+    };
+
+    template <typename Db, typename Statement>
+    struct tables_of<prepared_remove_t<Db, Statement>>
+    {
+      using type = typename tables_of<Statement>::type;
+    };
+
+    template <typename Db, typename Statement>
+    struct tables_of<prepared_execute_t<Db, Statement>>
+    {
+      using type = typename tables_of<Statement>::type;
+    };
+
+    template <typename Policy>
+    struct shape_keyword
+    {
+      static const char* get()
+      {
+        return nullptr;
+      }
+    };
+
+    template <>
+    struct shape_keyword<select_t>
+    {
+      static const char* get()
+      {
+        return "select";
+      }
+    };
+
+    template <>
+    struct shape_keyword<insert_t>
+    {
+      static const char* get()
+      {
+        return "insert";
+      }
+    };
+
+    template <>
+    struct shape_keyword<update_t>
+    {
+      static const char* get()
+      {
+        return "update";
+      }
+    };
+
+    template <>
+    struct shape_keyword<remove_t>
+    {
+      static const char* get()
+      {
+        return "remove";
+      }
+    };
+
+    inline const char* first_shape_keyword(std::initializer_list<const char*> keywords)
+    {
+      for (const auto keyword : keywords)
+      {
+        if (keyword)
+          return keyword;
+      }
+      return "statement";
+    }
+
+    template <typename T>
+    struct shape_keyword_of
+    {
+      static const char* get()
+      {
+        return "statement";
+      }
+    };
+
+    template <typename Db, typename... Policies>
+    struct shape_keyword_of<statement_t<Db, Policies...>>
+    {
+      static const char* get()
+      {
+        return first_shape_keyword({shape_keyword<Policies>::get()...});
+      }
+    };
+
+    template <typename... Tables>
+    std::string shape_table_names(const type_set<Tables...>&)
+    {
+      std::string names;
+      for (const auto name : std::initializer_list<const char*>{name_of<Tables>::char_ptr()...})
+      {
+        names.append(names.empty() ? " " : ",").append(name);
+      }
+      return names;
+    }
+  }
+
+  // Identifies statements of the same type for metrics and logs: The id is unique within the process, the name
+  // (e.g. "select tab_foo,tab_bar") consists of the kind of statement and the tables it uses.
+  // Prepared statements share the shape of the statement they were prepared from.
+  struct statement_shape_t
+  {
+    std::size_t id;
+    std::string name;
+  };
+
+  namespace detail
+  {
+    template <typename Statement>
+    const statement_shape_t& make_statement_shape()
+    {
+      static const statement_shape_t shape{
+          type_id<Statement>(),
+          shape_keyword_of<Statement>::get() + shape_table_names(typename tables_of<Statement>::type{})};
+      return shape;
+    }
+  }
+
+  template <typename T>
+  const statement_shape_t& statement_shape()
+  {
+    return detail::make_statement_shape<typename detail::shape_statement_of<T>::type>();
+  }
+}
+
+#endif
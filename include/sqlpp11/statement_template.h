@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_STATEMENT_TEMPLATE_H
+#define SQLPP_STATEMENT_TEMPLATE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <sqlpp11/parameter_list.h>
+#include <sqlpp11/data_types/no_value.h>
+
+namespace sqlpp
+{
+  namespace detail
+  {
+    inline std::size_t next_statement_template_id()
+    {
+      static std::atomic<std::size_t> last_id{0};
+      return ++last_id;
+    }
+  }
+
+  // An immutable statement that can be shared by any number of threads.
+  // It is prepared at most once per connection, see prepared_statement_cache_t.
+  template <typename Statement>
+  class statement_template_t
+  {
+  public:
+    using _statement_t = Statement;
+    using _parameter_list_t = make_parameter_list_t<Statement>;
+
+    statement_template_t(Statement statement)
+        : _statement(std::move(statement)), _id(detail::next_statement_template_id())
+    {
+    }
+
+    statement_template_t(const statement_template_t&) = default;
+    statement_template_t(statement_template_t&&) = default;
+    statement_template_t& operator=(const statement_template_t&) = delete;
+    statement_template_t& operator=(statement_template_t&&) = delete;
+    ~statement_template_t() = default;
+
+    const Statement& statement() const
+    {
+      return _statement;
+    }
+
+    // Copies share the id, and thus the prepared statements
+    std::size_t id() const
+    {
+      return _id;
+    }
+
+  private:
+    const Statement _statement;
+    const std::size_t _id;
+  };
+
+  template <typename Statement>
+  statement_template_t<Statement> make_statement_template(Statement statement)
+  {
+    return {std::move(statement)};
+  }
+
+  // The per-execution handle: It carries its own parameter values and refers to
+  // the prepared statement owned by the connection's cache.
+  template <typename Database, typename Prepared>
+  struct prepared_execution_t
+  {
+    using _traits = make_traits<no_value_t, tag::is_prepared_statement>;
+    using _nodes = detail::type_vector<>;
+
+    using _parameter_list_t = typename Prepared::_parameter_list_t;
+
+    using _run_check = consistent_t;
+
+    prepared_execution_t(Prepared& prepared) : _prepared(&prepared)
+    {
+    }
+
+    // Writes this handle's values into the shared prepared statement right before executing it (const, since
+    // connectors run const statements). Handles of one template must therefore not be executed by several threads
+    // at the same time, and executing one of them ends results of the others that are still being read.
+    auto _run(Database& db) const -> decltype(std::declval<const Prepared&>()._run(db))
+    {
+      _prepared->params = params;
+      return _prepared->_run(db);
+    }
+
+    _parameter_list_t params;
+
+  private:
+    Prepared* _prepared;
+  };
+
+  // Prepared statements of one connection, keyed by statement template.
+  // Like the connection itself, the cache must not be used by several threads at the same time.
+  template <typename Database>
+  class prepared_statement_cache_t
+  {
+    struct _entry_base
+    {
+      virtual ~_entry_base() = default;
+    };
+
+    template <typename Prepared>
+    struct _entry : public _entry_base
+    {
+      _entry(Prepared prepared) : _prepared(std::move(prepared))
+      {
+      }
+
+      Prepared _prepared;
+    };
+
+    std::unordered_map<std::size_t, std::unique_ptr<_entry_base>> _entries;
+
+  public:
+    template <typename Statement>
+    using _prepared_t = decltype(std::declval<Database&>().prepare(std::declval<const Statement&>()));
+
+    template <typename Statement>
+    auto get(Database& db, const statement_template_t<Statement>& t) -> _prepared_t<Statement>&
+    {
+      using _entry_t = _entry<_prepared_t<Statement>>;
+      auto it = _entries.find(t.id());
+      if (it == _entries.end())
+      {
+        it = _entries.emplace(t.id(), std::unique_ptr<_entry_base>(new _entry_t(db.prepare(t.statement())))).first;
+      }
+      return static_cast<_entry_t&>(*it->second)._prepared;
+    }
+
+    template <typename Statement>
+    auto bind(Database& db, const statement_template_t<Statement>& t)
+        -> prepared_execution_t<Database, _prepared_t<Statement>>
+    {
+      return {get(db, t)};
+    }
+
+    std::size_t size() const
+    {
+      return _entries.size();
+    }
+
+    // Required after reconnecting, since the prepared statements belong to the old session
+    void clear()
+    {
+      _entries.clear();
+    }
+  };
+}
+
+#endif
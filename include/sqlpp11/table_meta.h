@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SQLPP_TABLE_META_H
+#define SQLPP_TABLE_META_H
+
+#include <cstddef>
+#include <cstring>
+#include <sqlpp11/data_types.h>
+#include <sqlpp11/table.h>
+#include <sqlpp11/type_traits.h>
+#include <sqlpp11/detail/index_sequence.h>
+
+namespace sqlpp
+{
+  enum class data_type_id
+  {
+    no_value,
+    boolean,
+    integral,
+    unsigned_integral,
+    floating_point,
+    text,
+    day_point,
+    time_point,
+    time_of_day
+  };
+
+  inline const char* to_string(data_type_id id)
+  {
+    switch (id)
+    {
+      case data_type_id::no_value:
+        return "no_value";
+      case data_type_id::boolean:
+        return "boolean";
+      case data_type_id::integral:
+        return "integral";
+      case data_type_id::unsigned_integral:
+        return "unsigned_integral";
+      case data_type_id::floating_point:
+        return "floating_point";
+      case data_type_id::text:
+        return "text";
+      case data_type_id::day_point:
+        return "day_point";
+      case data_type_id::time_point:
+        return "time_point";
+      case data_type_id::time_of_day:
+        return "time_of_day";
+    }
+    return "";
+  }
+
+  template <typename ValueType>
+  struct data_type_id_of;
+
+#define SQLPP_DATA_TYPE_ID(value_type, id)                                                           \
+  template <>                                                                                        \
+  struct data_type_id_of<value_type> : public std::integral_constant<data_type_id, data_type_id::id> \
+  {                                                                                                  \
+  };
+
+  SQLPP_DATA_TYPE_ID(no_value_t, no_value)
+  SQLPP_DATA_TYPE_ID(boolean, boolean)
+  SQLPP_DATA_TYPE_ID(integral, integral)
+  SQLPP_DATA_TYPE_ID(unsigned_integral, unsigned_integral)
+  SQLPP_DATA_TYPE_ID(floating_point, floating_point)
+  SQLPP_DATA_TYPE_ID(text, text)
+  SQLPP_DATA_TYPE_ID(day_point, day_point)
+  SQLPP_DATA_TYPE_ID(time_point, time_point)
+  SQLPP_DATA_TYPE_ID(time_of_day, time_of_day)
+#undef SQLPP_DATA_TYPE_ID
+
+  struct column_meta_t
+  {
+    const char* name;
+    data_type_id data_type;
+    bool can_be_null;
+    bool require_insert;
+    bool must_not_insert;
+    bool must_not_update;
+    std::size_t index;  // position in all_of(table) and in the result row of select(all_of(table))
+  };
+
+  namespace detail
+  {
+    template <typename Table, typename ColumnSpec, std::size_t Index>
+    constexpr column_meta_t make_column_meta()
+    {
+      using _column_t = column_t<Table, ColumnSpec>;
+      return {name_of<_column_t>::char_ptr(),
+              data_type_id_of<value_type_of<_column_t>>::value,
+              column_spec_can_be_null_t<ColumnSpec>::value,
+              require_insert_t<_column_t>::value,
+              must_not_insert_t<_column_t>::value,
+              must_not_update_t<_column_t>::value,
+              Index};
+    }
+
+    template <typename Table, typename Indexes, typename... ColumnSpecs>
+    struct table_meta_impl;
+
+    template <typename Table, std::size_t... Is, typename... ColumnSpecs>
+    struct table_meta_impl<Table, index_sequence<Is...>, ColumnSpecs...>
+    {
+      static constexpr const char* name()
+      {
+        return name_of<Table>::char_ptr();
+      }
+
+      static constexpr std::size_t size()
+      {
+        return sizeof...(ColumnSpecs);
+      }
+
+      static constexpr column_meta_t columns[sizeof...(ColumnSpecs)] = {
+          make_column_meta<Table, ColumnSpecs, Is>()...};
+
+      // Returns the column with the given name or nullptr
+      static const column_meta_t* find(const char* column_name)
+      {
+        for (const auto& column : columns)
+        {
+          if (std::strcmp(column.name, column_name) == 0)
+            return &column;
+        }
+        return nullptr;
+      }
+    };
+
+    template <typename Table, std::size_t... Is, typename... ColumnSpecs>
+    constexpr column_meta_t table_meta_impl<Table, index_sequence<Is...>, ColumnSpecs...>::columns[];
+
+    template <typename Table, typename... ColumnSpecs>
+    auto table_meta_of(const table_t<Table, ColumnSpecs...>&)
+        -> table_meta_impl<Table, make_index_sequence<sizeof...(ColumnSpecs)>, ColumnSpecs...>;
+  }
+
+  // Compile time description of the columns of a table, e.g. for bulk loaders, exporters or schema checks:
+  //
+  //   for (const auto& column : sqlpp::table_meta<test::TabFoo>::columns)
+  //     std::cout << column.name << ' ' << sqlpp::to_string(column.data_type) << '\n';
+  template <typename Table>
+  struct table_meta : public decltype(detail::table_meta_of(std::declval<Table>()))
+  {
+  };
+}
+
+#endif
@@ -27,13 +27,62 @@
 #ifndef SQLPP_TRANSACTION_H
 #define SQLPP_TRANSACTION_H
 
+#include <chrono>
+#include <cstddef>
+#include <random>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <sqlpp11/exception.h>
+#include <sqlpp11/detail/void.h>
 
 namespace sqlpp
 {
   static constexpr bool quiet_auto_rollback = false;
   static constexpr bool report_auto_rollback = true;
 
+  enum class isolation_level
+  {
+    undefined,  // the database's default
+    serializable,
+    repeatable_read,
+    read_committed,
+    read_uncommitted
+  };
+
+  enum class transaction_access
+  {
+    read_write,
+    read_only
+  };
+
+  // Connectors throw this (or a derived class) if a transaction failed due to concurrent transactions
+  // and may succeed if it is tried again, see run_transaction().
+  class transaction_conflict : public exception
+  {
+  public:
+    enum class reason
+    {
+      serialization_failure,
+      deadlock,
+      lock_timeout
+    };
+
+    transaction_conflict(reason r, const std::string& what_arg) : exception(what_arg), _reason(r)
+    {
+    }
+
+    reason get_reason() const
+    {
+      return _reason;
+    }
+
+  private:
+    reason _reason;
+  };
+
   template <typename Db>
   class transaction_t
   {
@@ -48,6 +97,12 @@ namespace sqlpp
       _db.start_transaction();
     }
 
+    transaction_t(Db& db, isolation_level level, transaction_access access, bool report_unfinished_transaction)
+        : _db(db), _report_unfinished_transaction(report_unfinished_transaction)
+    {
+      _db.start_transaction(level, access);
+    }
+
     transaction_t(const transaction_t&) = delete;
     transaction_t(transaction_t&&) = default;
     transaction_t& operator=(const transaction_t&) = delete;
@@ -72,10 +127,11 @@ namespace sqlpp
       }
     }
 
+    // If the commit fails, the transaction is still rolled back by the destructor
     void commit()
     {
-      _finished = true;
       _db.commit_transaction();
+      _finished = true;
     }
 
     void rollback()
@@ -90,6 +146,131 @@ namespace sqlpp
   {
     return {db, report_unfinished_transaction};
   }
+
+  template <typename Db>
+  transaction_t<Db> start_transaction(Db& db,
+                                      isolation_level level,
+                                      transaction_access access = transaction_access::read_write,
+                                      bool report_unfinished_transaction = report_auto_rollback)
+  {
+    return {db, level, access, report_unfinished_transaction};
+  }
+
+  struct retry_policy_t
+  {
+    std::size_t max_attempts = 5;
+    std::chrono::milliseconds initial_backoff = std::chrono::milliseconds{5};
+    std::chrono::milliseconds max_backoff = std::chrono::milliseconds{500};
+    isolation_level isolation = isolation_level::undefined;
+    transaction_access access = transaction_access::read_write;
+  };
+
+  namespace detail
+  {
+    // Full jitter: A random duration between zero and the exponentially growing cap
+    inline std::chrono::milliseconds retry_backoff(const retry_policy_t& policy, std::size_t attempt)
+    {
+      thread_local std::minstd_rand engine{std::random_device{}()};
+      auto cap = policy.initial_backoff;
+      for (std::size_t i = 1; i < attempt and cap < policy.max_backoff; ++i)
+      {
+        cap *= 2;
+      }
+      if (cap > policy.max_backoff)
+        cap = policy.max_backoff;
+      if (cap.count() <= 0)
+        return std::chrono::milliseconds{0};
+      std::uniform_int_distribution<std::chrono::milliseconds::rep> distribution{0, cap.count()};
+      return std::chrono::milliseconds{distribution(engine)};
+    }
+
+    template <typename Db, typename Enable = void>
+    struct has_transaction_options : std::false_type
+    {
+    };
+
+    template <typename Db>
+    struct has_transaction_options<Db,
+                                   void_t<decltype(std::declval<Db&>().start_transaction(
+                                       isolation_level::undefined, transaction_access::read_write))>> : std::true_type
+    {
+    };
+
+    template <typename Db>
+    transaction_t<Db> start_transaction_for(Db& db, const retry_policy_t& policy, const std::true_type&)
+    {
+      return start_transaction(db, policy.isolation, policy.access, quiet_auto_rollback);
+    }
+
+    // Connectors without start_transaction(isolation_level, transaction_access) only support the defaults
+    template <typename Db>
+    transaction_t<Db> start_transaction_for(Db& db, const retry_policy_t& policy, const std::false_type&)
+    {
+      if (policy.isolation != isolation_level::undefined or policy.access != transaction_access::read_write)
+        throw exception("sqlpp11: connector does not support isolation levels or read only transactions");
+      return start_transaction(db, quiet_auto_rollback);
+    }
+
+    template <typename Db>
+    transaction_t<Db> start_transaction_for(Db& db, const retry_policy_t& policy)
+    {
+      return start_transaction_for(db, policy, has_transaction_options<Db>{});
+    }
+
+    template <typename Result>
+    struct transaction_attempt_t
+    {
+      template <typename Db, typename Function>
+      static Result _run(Db& db, Function& function, const retry_policy_t& policy)
+      {
+        auto tx = start_transaction_for(db, policy);
+        Result result = function(db);
+        tx.commit();
+        return result;
+      }
+    };
+
+    template <>
+    struct transaction_attempt_t<void>
+    {
+      template <typename Db, typename Function>
+      static void _run(Db& db, Function& function, const retry_policy_t& policy)
+      {
+        auto tx = start_transaction_for(db, policy);
+        function(db);
+        tx.commit();
+      }
+    };
+  }
+
+  // Runs function(db) in a transaction and commits.
+  // If the connector reports a transaction_conflict (in the function or during commit), the transaction
+  // is rolled back and the function is called again after a randomized, exponentially growing delay.
+  // The function must therefore not have side effects outside of the transaction.
+  // Connectors that only offer start_transaction() are supported as long as the policy asks for the default
+  // isolation level and read_write access, otherwise an exception is thrown.
+  // Other exceptions, and the conflict of the last attempt, are passed on to the caller.
+  // References returned by the function are returned as copies, since they would typically refer to
+  // state of the function or the transaction.
+  template <typename Db, typename Function>
+  auto run_transaction(Db& db, Function function, const retry_policy_t& policy = retry_policy_t{}) ->
+      typename std::decay<decltype(function(db))>::type
+  {
+    using _attempt_t = detail::transaction_attempt_t<typename std::decay<decltype(function(db))>::type>;
+    for (std::size_t attempt = 1;; ++attempt)
+    {
+      try
+      {
+        return _attempt_t::_run(db, function, policy);
+      }
+      catch (const transaction_conflict&)
+      {
+        if (attempt >= policy.max_attempts)
+          throw;
+      }
+      std::this_thread::sleep_for(detail::retry_backoff(policy, attempt));
+    }
+  }
 }
 
 #endif
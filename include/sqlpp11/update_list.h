@@ -50,6 +50,11 @@ namespace sqlpp
 
     std::tuple<Assignments...> _assignments;
     interpretable_list_t<Database> _dynamic_assignments;
+
+    void _use_arena(arena_t* arena)
+    {
+      _dynamic_assignments._use_arena(arena);
+    }
   };
 
   SQLPP_PORTABLE_STATIC_ASSERT(
@@ -96,6 +101,13 @@ namespace sqlpp
         _add_impl(assignment, ok());  // dispatch to prevent compile messages after the static_assert
       }
 
+      // Removes the dynamic parts, but keeps the allocated capacity for re-use
+      void clear()
+      {
+        static_assert(_is_dynamic::value, "update_list::clear() can only be called for dynamic_set");
+        _data._dynamic_assignments.clear();
+      }
+
     private:
       template <typename Assignment>
       void _add_impl(Assignment assignment, const std::true_type&)
@@ -51,6 +51,11 @@ namespace sqlpp
 
     std::tuple<Tables...> _tables;
     interpretable_list_t<Database> _dynamic_tables;
+
+    void _use_arena(arena_t* arena)
+    {
+      _dynamic_tables._use_arena(arena);
+    }
   };
 
   // USING
@@ -55,6 +55,11 @@ namespace sqlpp
 
     Expression _expression;
     interpretable_list_t<Database> _dynamic_expressions;
+
+    void _use_arena(arena_t* arena)
+    {
+      _dynamic_expressions._use_arena(arena);
+    }
   };
 
   SQLPP_PORTABLE_STATIC_ASSERT(
@@ -101,6 +106,13 @@ namespace sqlpp
         _add_impl(expression, ok());  // dispatch to prevent compile messages after the static_assert
       }
 
+      // Removes the dynamic parts, but keeps the allocated capacity for re-use
+      void clear()
+      {
+        static_assert(_is_dynamic::value, "where::clear() can only be called for dynamic_where");
+        _data._dynamic_expressions.clear();
+      }
+
     private:
       template <typename Expr>
       void _add_impl(Expr expression, const std::true_type&)
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_TEST_ALLOCATION_COUNTER_H
+#define SQLPP_TEST_ALLOCATION_COUNTER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Reports the caller's file and line
+#define SQLPP_EXPECT_NO_ALLOCATIONS(audit, what) test::expect_no_allocations(__FILE__, __LINE__, audit, what)
+
+namespace test
+{
+  // Number of calls to the global operator new (all variants, the aligned ones if the compiler supports them) in
+  // this process, see AllocationCounter.cpp
+  std::size_t allocation_count();
+
+  // Counts the heap allocations of the current thread's code (and of any other thread) since construction
+  class allocation_audit_t
+  {
+    std::size_t _start;
+
+  public:
+    allocation_audit_t() : _start(allocation_count())
+    {
+    }
+
+    std::size_t allocations() const
+    {
+      return allocation_count() - _start;
+    }
+  };
+
+  // Takes plain strings, so that calling it does not allocate, see SQLPP_EXPECT_NO_ALLOCATIONS
+  inline void expect_no_allocations(const char* file, int lineNo, const allocation_audit_t& audit, const char* what)
+  {
+    const auto allocations = audit.allocations();
+    if (allocations != 0)
+    {
+      std::cerr << file << " " << lineNo << '\n' << what << ": " << allocations << " allocation(s)\n";
+      throw std::runtime_error("unexpected allocations");
+    }
+  }
+
+  // Serializer context that writes into a pre-reserved string
+  struct reserved_context_t
+  {
+    std::string _text;
+
+    reserved_context_t(std::size_t capacity)
+    {
+      _text.reserve(capacity);
+    }
+
+    const std::string& str() const
+    {
+      return _text;
+    }
+
+    void reset()
+    {
+      _text.clear();
+    }
+
+    reserved_context_t& operator<<(const char* text)
+    {
+      _text.append(text);
+      return *this;
+    }
+
+    reserved_context_t& operator<<(char c)
+    {
+      _text.push_back(c);
+      return *this;
+    }
+
+    reserved_context_t& operator<<(const std::string& text)
+    {
+      _text.append(text);
+      return *this;
+    }
+
+    template <typename Integral>
+    typename std::enable_if<std::is_integral<Integral>::value, reserved_context_t&>::type operator<<(Integral value)
+    {
+      char buffer[32];
+      const auto length = std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+      _text.append(buffer, static_cast<std::size_t>(length));
+      return *this;
+    }
+
+    reserved_context_t& operator<<(double value)
+    {
+      char buffer[32];
+      const auto length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+      _text.append(buffer, static_cast<std::size_t>(length));
+      return *this;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "AllocationCounter.h"
+#include "Sample.h"
+#include <sqlpp11/sqlpp11.h>
+
+namespace
+{
+  // Stands in for a connector's prepared statement
+  struct BindTarget
+  {
+    int64_t _sum = 0;
+    std::size_t _nulls = 0;
+
+    void _bind_integral_parameter(std::size_t, const int64_t* value, bool is_null)
+    {
+      if (is_null)
+        ++_nulls;
+      else
+        _sum += *value;
+    }
+
+    void _bind_boolean_parameter(std::size_t, const signed char* value, bool is_null)
+    {
+      if (is_null)
+        ++_nulls;
+      else
+        _sum += *value;
+    }
+
+    void _bind_floating_point_parameter(std::size_t, const double* value, bool is_null)
+    {
+      if (is_null)
+        ++_nulls;
+      else
+        _sum += static_cast<int64_t>(*value);
+    }
+  };
+}
+
+int BindParameters(int, char* [])
+{
+  const auto foo = test::TabFoo{};
+  const auto bar = test::TabBar{};
+
+  const auto s = select(bar.alpha)
+                     .from(bar.join(foo).on(bar.alpha == foo.omega))
+                     .where(bar.alpha > parameter(bar.alpha) and bar.gamma == parameter(bar.gamma) and
+                            foo.omega < parameter(foo.omega));
+  sqlpp::make_parameter_list_t<decltype(s)> params;
+  BindTarget target;
+
+  const auto audit = test::allocation_audit_t{};
+  for (int i = 0; i < 100; ++i)
+  {
+    params.alpha = i;
+    params.gamma = true;
+    params.omega.set_null();
+    params._bind(target);
+  }
+  SQLPP_EXPECT_NO_ALLOCATIONS(audit, "binding parameters");
+
+  if (target._sum != 4950 + 100 or target._nulls != 100)
+    throw std::runtime_error("unexpected parameter values");
+
+  return 0;
+}
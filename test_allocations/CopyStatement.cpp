@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "AllocationCounter.h"
+#include "MockDb.h"
+#include "Sample.h"
+#include <sqlpp11/sqlpp11.h>
+#include <stdexcept>
+#include <string>
+
+int CopyStatement(int, char* [])
+{
+  MockDb db = {};
+  const auto bar = test::TabBar{};
+
+  // Copies of typical dynamic parts are stored inline, copying a statement allocates the lists only,
+  // no matter how many parts they hold (as with the former shared ownership of the parts)
+  auto s = dynamic_select(db, bar.alpha).from(bar).dynamic_where();
+  s.where.add(bar.alpha > 7);
+  {
+    const auto audit = test::allocation_audit_t{};
+    const auto copy = s;
+    if (audit.allocations() != 1)
+      throw std::runtime_error("copying a statement with one dynamic condition: " +
+                               std::to_string(audit.allocations()) + " allocation(s)");
+  }
+
+  for (int i = 0; i < 16; ++i)
+  {
+    s.where.add(bar.alpha > i);
+    s.where.add(bar.beta == "cheesecake");
+  }
+  {
+    const auto audit = test::allocation_audit_t{};
+    const auto copy = s;
+    if (audit.allocations() != 1)
+      throw std::runtime_error("copying a statement with 33 dynamic conditions: " +
+                               std::to_string(audit.allocations()) + " allocation(s)");
+  }
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "AllocationCounter.h"
+#include "Sample.h"
+#include "MockRowsDb.h"
+#include <sqlpp11/sqlpp11.h>
+
+int IterateResult(int, char* [])
+{
+  const auto foo = test::TabFoo{};
+  const auto bar = test::TabBar{};
+
+  MockRowsDb db({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+
+  {
+    auto result = db(select(bar.alpha, bar.delta).from(bar).unconditionally());
+    int64_t sum = 0;
+    const auto audit = test::allocation_audit_t{};
+    for (const auto& row : result)
+    {
+      sum += row.alpha + row.delta;
+    }
+    SQLPP_EXPECT_NO_ALLOCATIONS(audit, "iterating integral columns");
+    if (sum != 110)
+      throw std::runtime_error("unexpected integral results");
+  }
+
+  {
+    auto result = db(select(foo.omega).from(foo).unconditionally());
+    double sum = 0;
+    const auto audit = test::allocation_audit_t{};
+    while (not result.empty())
+    {
+      sum += result.front().omega;
+      result.pop_front();
+    }
+    SQLPP_EXPECT_NO_ALLOCATIONS(audit, "iterating floating point columns");
+    if (sum != 55.0)
+      throw std::runtime_error("unexpected floating point results");
+  }
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "AllocationCounter.h"
+#include "Sample.h"
+#include <sqlpp11/sqlpp11.h>
+#include <memory>
+
+int SerializeSelect(int, char* [])
+{
+  const auto foo = test::TabFoo{};
+  const auto bar = test::TabBar{};
+
+  {
+    const auto audit = test::allocation_audit_t{};
+    std::unique_ptr<int> p(new int{17});
+    if (audit.allocations() != 1)
+      throw std::runtime_error("allocations are not counted");
+  }
+
+  test::reserved_context_t context{1024};
+  const auto s = select(bar.alpha, bar.delta, foo.omega)
+                     .from(bar.join(foo).on(bar.alpha == foo.omega))
+                     .where(bar.alpha > 7 and (bar.gamma or foo.omega < 3.5))
+                     .order_by(bar.alpha.desc())
+                     .limit(10u);
+
+  // The first run may initialize static data
+  serialize(s, context);
+  const auto expected = context.str();
+
+  context.reset();
+  const auto audit = test::allocation_audit_t{};
+  serialize(s, context);
+  SQLPP_EXPECT_NO_ALLOCATIONS(audit, "serializing a static select");
+
+  if (context.str() != expected)
+    throw std::runtime_error("unexpected serialization");
+
+  return 0;
+}
@@ -0,0 +1,22 @@
+#include <SplitSample_TabBar.h>
+#include <SplitSample_fwd.h>
+#include <sqlpp11/select.h>
+#include <type_traits>
+
+// Only needs the forward declarations
+void use(const split_test::TabFoo& foo);
+
+int main()
+{
+  const auto bar = split_test::TabBar{};
+
+  using select_t = decltype(select(all_of(bar)).from(bar).unconditionally());
+  static_assert(std::is_same<select_t::_result_row_t<MockDb>, split_test::TabBar_::row_t<MockDb>>::value,
+                "row_t should be the result row of select(all_of(table))");
+
+  MockDb db;
+  for (const auto& row : db(select(all_of(bar)).from(bar).unconditionally()))
+  {
+    (void)row.alpha;
+  }
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2016-2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sqlpp11/detail/type_set.h>
+#include <type_traits>
+
+namespace
+{
+  struct A
+  {
+  };
+  struct B
+  {
+  };
+  struct C
+  {
+  };
+
+  using sqlpp::detail::type_set;
+
+  using empty = type_set<>;
+  using a = type_set<A>;
+  using b = type_set<B>;
+  using ab = type_set<A, B>;
+  using ba = type_set<B, A>;
+  using bc = type_set<B, C>;
+
+  template <typename L, typename R>
+  struct is_same_set : std::integral_constant<bool, sqlpp::detail::is_superset_of<L, R>::value and
+                                                        sqlpp::detail::is_subset_of<L, R>::value>
+  {
+  };
+
+  void make_type_set()
+  {
+    using sqlpp::detail::make_type_set_t;
+    static_assert(std::is_same<make_type_set_t<>, empty>::value, "");
+    static_assert(std::is_same<make_type_set_t<A>, a>::value, "");
+    static_assert(std::is_same<make_type_set_t<A, A>, a>::value, "");
+    static_assert(std::is_same<make_type_set_t<A, B>, ab>::value, "");
+    static_assert(std::is_same<make_type_set_t<B, A>, ba>::value, "");
+    // duplicates are removed, the first occurrence is kept
+    static_assert(std::is_same<make_type_set_t<A, B, A>, ab>::value, "");
+    static_assert(std::is_same<make_type_set_t<B, A, A, B, B>, ba>::value, "");
+    static_assert(std::is_same<make_type_set_t<A, B, C, C, B, A>, type_set<A, B, C>>::value, "");
+    static_assert(sqlpp::detail::has_duplicates<A, B, A>::value, "");
+    static_assert(not sqlpp::detail::has_duplicates<A, B>::value, "");
+    static_assert(not sqlpp::detail::has_duplicates<>::value, "");
+  }
+
+  void joined_set()
+  {
+    using sqlpp::detail::joined_set_t;
+    static_assert(std::is_same<joined_set_t<empty, empty>, empty>::value, "");
+    static_assert(std::is_same<joined_set_t<a, empty>, a>::value, "");
+    static_assert(std::is_same<joined_set_t<empty, a>, a>::value, "");
+    static_assert(std::is_same<joined_set_t<a, a>, a>::value, "");
+    static_assert(std::is_same<joined_set_t<a, b>, ab>::value, "");
+    static_assert(std::is_same<joined_set_t<ab, ba>, ab>::value, "");
+    static_assert(std::is_same<joined_set_t<ab, bc>, type_set<A, B, C>>::value, "");
+    static_assert(std::is_same<sqlpp::detail::make_joined_set_t<a, b, bc, empty>, type_set<A, B, C>>::value, "");
+    static_assert(std::is_same<sqlpp::detail::make_joined_set_t<>, empty>::value, "");
+  }
+
+  void make_difference_set()
+  {
+    using sqlpp::detail::make_difference_set_t;
+    static_assert(std::is_same<make_difference_set_t<empty, empty>, empty>::value, "");
+    static_assert(std::is_same<make_difference_set_t<empty, a>, empty>::value, "");
+    static_assert(std::is_same<make_difference_set_t<a, empty>, a>::value, "");
+    static_assert(std::is_same<make_difference_set_t<a, a>, empty>::value, "");
+    static_assert(std::is_same<make_difference_set_t<a, b>, a>::value, "");
+    static_assert(std::is_same<make_difference_set_t<ab, b>, a>::value, "");
+    static_assert(std::is_same<make_difference_set_t<ab, ba>, empty>::value, "");
+    static_assert(std::is_same<make_difference_set_t<ab, bc>, a>::value, "");
+  }
+
+  void make_intersect_set()
+  {
+    using sqlpp::detail::make_intersect_set_t;
+    static_assert(std::is_same<make_intersect_set_t<empty, empty>, empty>::value, "");
+    static_assert(std::is_same<make_intersect_set_t<empty, a>, empty>::value, "");
+    static_assert(std::is_same<make_intersect_set_t<a, empty>, empty>::value, "");
+    static_assert(std::is_same<make_intersect_set_t<a, a>, a>::value, "");
+    static_assert(std::is_same<make_intersect_set_t<a, b>, empty>::value, "");
+    static_assert(std::is_same<make_intersect_set_t<ab, ba>, ab>::value, "");
+    static_assert(std::is_same<make_intersect_set_t<ab, bc>, b>::value, "");
+  }
+
+  void is_superset_of()
+  {
+    using sqlpp::detail::is_superset_of;
+    static_assert(is_superset_of<empty, empty>::value, "");
+    static_assert(is_superset_of<a, empty>::value, "");
+    static_assert(not is_superset_of<empty, a>::value, "");
+    static_assert(is_superset_of<a, a>::value, "");
+    static_assert(not is_superset_of<a, b>::value, "");
+    static_assert(is_superset_of<ab, a>::value, "");
+    static_assert(is_superset_of<ab, ba>::value, "");
+    static_assert(not is_superset_of<a, ab>::value, "");
+    static_assert(not is_superset_of<ab, bc>::value, "");
+    static_assert(sqlpp::detail::is_subset_of<a, ab>::value, "");
+    static_assert(is_same_set<ab, ba>::value and not is_same_set<ab, bc>::value, "");
+  }
+
+  void is_disjunct_from()
+  {
+    using sqlpp::detail::is_disjunct_from;
+    static_assert(is_disjunct_from<empty, empty>::value, "");
+    static_assert(is_disjunct_from<a, empty>::value, "");
+    static_assert(is_disjunct_from<empty, a>::value, "");
+    static_assert(not is_disjunct_from<a, a>::value, "");
+    static_assert(is_disjunct_from<a, b>::value, "");
+    static_assert(not is_disjunct_from<ab, b>::value, "");
+    static_assert(not is_disjunct_from<ab, bc>::value, "");
+    static_assert(is_disjunct_from<a, bc>::value, "");
+  }
+}
+
+int main(int, char* [])
+{
+  make_type_set();
+  joined_set();
+  make_difference_set();
+  make_intersect_set();
+  is_superset_of();
+  is_disjunct_from();
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include "MockAsyncDb.h"
+#include <sqlpp11/sqlpp11.h>
+#include <iostream>
+
+int Async(int, char* [])
+{
+  MockAsyncDb db;
+  const auto t = test::TabBar{};
+
+  // Selects yield the usual typed results
+  {
+    auto pending = db.async(select(all_of(t)).from(t).unconditionally());
+    auto result = pending.get();
+    for (const auto& row : result)
+    {
+      std::cerr << row.alpha << row.beta << std::endl;
+    }
+  }
+
+  // Dynamic selects, too
+  {
+    auto s = dynamic_select(db).dynamic_columns(t.alpha).from(t).unconditionally();
+    s.selected_columns.add(t.beta);
+    for (const auto& row : sqlpp::async(db, s).get())
+    {
+      std::cerr << row.alpha << row.at("beta") << std::endl;
+    }
+  }
+
+  // Insert, update and remove return the number of affected rows
+  {
+    if (db.async(insert_into(t).set(t.beta = "cheesecake", t.gamma = true)).get() != 1)
+      throw std::runtime_error("unexpected number of inserted rows");
+    if (db.async(update(t).set(t.beta = "cake").where(t.alpha == 7)).get() != 1)
+      throw std::runtime_error("unexpected number of updated rows");
+    if (db.async(remove_from(t).where(t.alpha == 7)).get() != 1)
+      throw std::runtime_error("unexpected number of removed rows");
+  }
+
+  // Continuations
+  {
+    auto doubled = db.async(remove_from(t).unconditionally()).then([](size_t n) { return 2 * n; });
+    if (doubled.get() != 2)
+      throw std::runtime_error("unexpected continuation result");
+  }
+
+  // Exceptions are delivered via get()
+  {
+    sqlpp::async_promise_t<size_t> promise;
+    auto pending = promise.get_async();
+    promise.set_exception(std::make_exception_ptr(sqlpp::exception("expected")));
+    try
+    {
+      pending.get();
+      throw std::logic_error("exception expected");
+    }
+    catch (const sqlpp::exception&)
+    {
+    }
+  }
+
+  // Connectors without asynchronous interface run on an executor
+  {
+    MockDb plain_db;
+    MockThreadPool pool;
+    auto pending = sqlpp::async(plain_db, select(all_of(t)).from(t).unconditionally(), pool);
+    pending.wait();
+    for (const auto& row : pending.get())
+    {
+      std::cerr << row.alpha << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include "MockRowsDb.h"
+#include <sqlpp11/caching_connection.h>
+#include <sqlpp11/sqlpp11.h>
+#include <chrono>
+#include <thread>
+
+int CachingConnection(int, char* [])
+{
+  const auto f = test::TabFoo{};
+  const auto t = test::TabBar{};
+
+  MockRowsDb connection({1, 2, 3});
+  auto config = sqlpp::result_cache_config_t{};
+  config.ttl = std::chrono::milliseconds{50};
+  sqlpp::caching_connection<MockRowsDb> db(connection, config);
+
+  // Repeated selects are served from the cache
+  for (int i = 0; i < 3; ++i)
+  {
+    int64_t sum = 0;
+    for (const auto& row : db(select(t.alpha).from(t).where(t.alpha > 0)))
+    {
+      sum += row.alpha;
+    }
+    if (sum != 6)
+      throw std::runtime_error("unexpected cached rows");
+  }
+  if (connection._selects != 1 or db.metrics().hits != 2 or db.metrics().misses != 1)
+    throw std::runtime_error("select was not cached");
+
+  // Different values are different entries
+  db(select(t.alpha).from(t).where(t.alpha > 1));
+  db(select(f.omega).from(f.join(t).on(f.omega == t.alpha)).unconditionally());
+  db(select(f.omega).from(f).unconditionally());
+  if (connection._selects != 4 or db.size() != 4)
+    throw std::runtime_error("unexpected number of entries");
+
+  // Writes invalidate the entries that use the table
+  db(update(t).set(t.gamma = false).where(t.alpha == 7));
+  if (db.size() != 1 or db.metrics().invalidations != 3)
+    throw std::runtime_error("update did not invalidate the entries of its table");
+  db(insert_into(f).set(f.omega = 17));
+  if (db.size() != 0)
+    throw std::runtime_error("insert did not invalidate the entries of its table");
+
+  // Sub-selects are tracked, too
+  db(select(t.alpha).from(t).where(t.alpha.in(select(f.omega).from(f).unconditionally())));
+  db(remove_from(f).unconditionally());
+  if (db.size() != 0)
+    throw std::runtime_error("remove did not invalidate the entry with a sub-select");
+
+  // Entries expire
+  const auto selects = connection._selects;
+  db(select(t.alpha).from(t).unconditionally());
+  std::this_thread::sleep_for(std::chrono::milliseconds{60});
+  db(select(t.alpha).from(t).unconditionally());
+  if (connection._selects != selects + 2)
+    throw std::runtime_error("entry did not expire");
+
+  // Dynamic selects
+  {
+    auto s = dynamic_select(db).dynamic_columns(t.alpha).from(t).dynamic_where();
+    s.selected_columns.add(t.beta);
+    s.where.add(t.alpha > 1);
+    for (const auto& row : db(s))
+    {
+      if (not row.at("beta").is_null())
+        throw std::runtime_error("unexpected dynamic field");
+    }
+    const auto results = db(s);
+    if (results.front().alpha.value() != 1)
+      throw std::runtime_error("unexpected dynamic row");
+  }
+
+  // Selects within transactions are not cached
+  {
+    db.clear();
+    auto tx = start_transaction(db);
+    db(select(t.alpha).from(t).unconditionally());
+    tx.commit();
+    if (db.size() != 0)
+      throw std::runtime_error("select within transaction was cached");
+  }
+
+  // A failed commit is rolled back, afterwards selects are cached again
+  {
+    db.clear();
+    connection._commit_conflicts = 1;
+    try
+    {
+      auto tx = start_transaction(db);
+      tx.commit();
+      throw std::logic_error("commit conflict was swallowed");
+    }
+    catch (const sqlpp::transaction_conflict&)
+    {
+    }
+    if (connection._rolled_back_transactions != 1)
+      throw std::runtime_error("failed commit was not rolled back");
+    db(select(t.alpha).from(t).unconditionally());
+    if (db.size() != 1)
+      throw std::runtime_error("select after failed commit was not cached");
+  }
+
+  // The memory budget is respected
+  {
+    MockRowsDb big_connection(std::vector<int64_t>(1000, 1));
+    auto small = sqlpp::result_cache_config_t{};
+    small.max_bytes = 4096;
+    sqlpp::caching_connection<MockRowsDb> small_db(big_connection, small);
+    small_db(select(t.alpha).from(t).unconditionally());
+    if (small_db.size() != 0)
+      throw std::runtime_error("entry exceeding the budget was cached");
+
+    MockRowsDb small_connection({1});
+    sqlpp::caching_connection<MockRowsDb> lru_db(small_connection, small);
+    for (int i = 0; i < 100; ++i)
+    {
+      lru_db(select(t.alpha).from(t).where(t.alpha == i));
+    }
+    if (lru_db.bytes_used() > small.max_bytes or lru_db.metrics().evictions == 0)
+      throw std::runtime_error("memory budget was not enforced");
+    lru_db.invalidate(t);
+    if (lru_db.size() != 0)
+      throw std::runtime_error("explicit invalidation failed");
+  }
+
+  return 0;
+}
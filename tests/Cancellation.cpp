@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include "MockRowsDb.h"
+#include <sqlpp11/cancellation.h>
+#include <sqlpp11/sqlpp11.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+  // Offers the optional cancellation hooks, the simulated delay ends early when cancelled or timed out
+  struct CancellableDb : public MockRowsDb
+  {
+    std::atomic<bool> _cancel_requested{false};
+    std::chrono::milliseconds _timeout{0};
+    std::size_t _timeouts_set = 0;
+    std::size_t _cancels = 0;
+    std::chrono::milliseconds _set_timeout_delay{0};  // simulates a slow round trip before the statement is sent
+
+    CancellableDb(std::vector<int64_t> values) : MockRowsDb(std::move(values))
+    {
+    }
+
+    template <typename T>
+    auto operator()(const T& t) -> decltype(t._run(*this))
+    {
+      ++_executed_statements;
+      return t._run(*this);
+    }
+
+    template <typename Select>
+    MockRowsResult select(const Select&)
+    {
+      ++_selects;
+      const auto start = std::chrono::steady_clock::now();
+      while (std::chrono::steady_clock::now() - start < _delay)
+      {
+        if (_cancel_requested)
+          throw sqlpp::exception("canceling statement due to user request");
+        if (_timeout.count() and std::chrono::steady_clock::now() - start >= _timeout)
+          throw sqlpp::exception("canceling statement due to statement timeout");
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      }
+      return MockRowsResult{_values};
+    }
+
+    void set_statement_timeout(std::chrono::milliseconds timeout)
+    {
+      if (timeout.count())
+      {
+        ++_timeouts_set;
+        std::this_thread::sleep_for(_set_timeout_delay);
+      }
+      _timeout = timeout;
+    }
+
+    void cancel()
+    {
+      ++_cancels;
+      _cancel_requested = true;
+    }
+  };
+}
+
+int Cancellation(int, char* [])
+{
+  const auto t = test::TabBar{};
+
+  // Tokens
+  {
+    if (sqlpp::cancellation_token_t{}.is_cancelled() or sqlpp::cancellation_token_t{}.has_deadline())
+      throw std::runtime_error("default token must never fire");
+
+    sqlpp::cancellation_source_t source;
+    const auto token = source.token();
+    std::size_t callbacks = 0;
+    {
+      const auto registration = token.on_cancel([&] { ++callbacks; });
+      if (token.is_cancelled())
+        throw std::runtime_error("token fired too early");
+      source.cancel();
+      source.cancel();
+    }
+    if (not token.is_cancelled() or callbacks != 1)
+      throw std::runtime_error("cancel did not reach the token");
+    token.on_cancel([&] { ++callbacks; });
+    if (callbacks != 2)
+      throw std::runtime_error("late registrations must be called right away");
+
+    const auto expired = sqlpp::cancellation_token_t::after(std::chrono::milliseconds{0});
+    if (not expired.is_cancelled() or expired.remaining().count() != 0)
+      throw std::runtime_error("expired deadline did not fire");
+    const auto pending = sqlpp::cancellation_token_t::after(std::chrono::seconds{10});
+    if (pending.is_cancelled() or pending.remaining() <= std::chrono::seconds{9})
+      throw std::runtime_error("unexpected remaining time");
+  }
+
+  // Statements are not sent once the token has fired
+  {
+    CancellableDb db({1, 2, 3});
+    sqlpp::cancellation_source_t source;
+    source.cancel();
+    try
+    {
+      db(sqlpp::cancellable(select(t.alpha).from(t).unconditionally(), source.token()));
+      throw std::runtime_error("cancelled statement was run");
+    }
+    catch (const sqlpp::statement_cancelled&)
+    {
+    }
+    if (db._selects != 0)
+      throw std::runtime_error("cancelled statement reached the database");
+  }
+
+  // Statements are not sent if the token fires while preparing the execution
+  {
+    CancellableDb db({1, 2, 3});
+    db._set_timeout_delay = std::chrono::milliseconds{20};
+    try
+    {
+      db(sqlpp::cancellable(select(t.alpha).from(t).unconditionally(),
+                            sqlpp::cancellation_token_t::after(std::chrono::milliseconds{5})));
+      throw std::runtime_error("expired statement was run");
+    }
+    catch (const sqlpp::statement_cancelled&)
+    {
+    }
+    if (db._selects != 0)
+      throw std::runtime_error("expired statement reached the database");
+  }
+
+  // Cancellable statements own their statement and can be stored
+  {
+    CancellableDb db({1, 2, 3});
+    const auto c = sqlpp::cancellable(select(t.alpha).from(t).unconditionally(),
+                                      sqlpp::cancellation_token_t::after(std::chrono::seconds{10}));
+    int64_t sum = 0;
+    for (const auto& row : db(c))
+    {
+      sum += row.alpha;
+    }
+    if (sum != 6)
+      throw std::runtime_error("stored cancellable statement returned unexpected rows");
+  }
+
+  // Deadlines set a server side timeout for the duration of the execution
+  {
+    CancellableDb db({1, 2, 3});
+    int64_t sum = 0;
+    for (const auto& row : db(sqlpp::cancellable(select(t.alpha).from(t).unconditionally(),
+                                                 sqlpp::cancellation_token_t::after(std::chrono::seconds{10}))))
+    {
+      sum += row.alpha;
+    }
+    if (sum != 6 or db._timeouts_set != 1 or db._timeout.count() != 0)
+      throw std::runtime_error("statement timeout was not set and reset");
+
+    db._delay = std::chrono::seconds{5};
+    const auto start = std::chrono::steady_clock::now();
+    try
+    {
+      db(sqlpp::cancellable(select(t.alpha).from(t).unconditionally(),
+                            sqlpp::cancellation_token_t::after(std::chrono::milliseconds{20})));
+      throw std::runtime_error("statement timeout was ignored");
+    }
+    catch (const sqlpp::exception& e)
+    {
+      if (std::string(e.what()) != "canceling statement due to statement timeout")
+        throw;
+    }
+    if (std::chrono::steady_clock::now() - start >= db._delay or db._timeout.count() != 0)
+      throw std::runtime_error("statement timeout did not stop the statement");
+  }
+
+  // Cancelling from another thread reaches the running statement
+  {
+    CancellableDb db({1, 2, 3});
+    db._delay = std::chrono::seconds{5};
+    sqlpp::cancellation_source_t source;
+    std::thread canceller([&]
+                          {
+                            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+                            source.cancel();
+                          });
+    const auto start = std::chrono::steady_clock::now();
+    try
+    {
+      db(sqlpp::cancellable(select(t.alpha).from(t).unconditionally(), source.token()));
+      canceller.join();
+      throw std::runtime_error("cancel was ignored");
+    }
+    catch (const sqlpp::exception& e)
+    {
+      canceller.join();
+      if (std::string(e.what()) != "canceling statement due to user request")
+        throw;
+    }
+    if (std::chrono::steady_clock::now() - start >= db._delay or db._cancels != 1)
+      throw std::runtime_error("cancel did not stop the statement");
+  }
+
+  // Iteration stops once the token fires
+  {
+    MockRowsDb db({1, 2, 3});
+    sqlpp::cancellation_source_t source;
+    std::size_t rows = 0;
+    try
+    {
+      for (const auto& row : db(sqlpp::cancellable(select(t.alpha).from(t).unconditionally(), source.token())))
+      {
+        (void)row;
+        ++rows;
+        source.cancel();
+      }
+      throw std::runtime_error("iteration was not stopped");
+    }
+    catch (const sqlpp::statement_cancelled&)
+    {
+    }
+    if (rows != 1)
+      throw std::runtime_error("unexpected number of rows before cancellation");
+  }
+
+  // Prepared statements
+  {
+    CancellableDb db({});
+    auto prepared = db.prepare(insert_into(t).set(t.beta = parameter(t.beta), t.gamma = true));
+    prepared.params.beta = "cheesecake";
+    const auto token = sqlpp::cancellation_token_t::after(std::chrono::seconds{10});
+    const size_t inserted = db(sqlpp::cancellable(prepared, token));
+    (void)inserted;
+    if (db._timeouts_set != 1 or db._timeout.count() != 0)
+      throw std::runtime_error("statement timeout was not set for prepared statement");
+
+    try
+    {
+      db(sqlpp::cancellable(prepared, sqlpp::cancellation_token_t::after(std::chrono::milliseconds{0})));
+      throw std::runtime_error("cancelled prepared statement was run");
+    }
+    catch (const sqlpp::statement_cancelled&)
+    {
+    }
+    if (db._executed_statements != 2 or db._timeouts_set != 1)
+      throw std::runtime_error("cancelled prepared statement reached the database");
+  }
+
+  return 0;
+}
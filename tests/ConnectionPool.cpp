@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include "MockDb.h"
+#include <sqlpp11/connection_pool.h>
+#include <sqlpp11/functions.h>
+#include <sqlpp11/select.h>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+  void require(bool condition, const char* message)
+  {
+    if (not condition)
+      throw std::runtime_error(message);
+  }
+}
+
+int ConnectionPool(int, char* [])
+{
+  const auto t = test::TabBar{};
+
+  using _lease_t = sqlpp::connection_pool<MockDb>::lease_t;
+  static_assert(std::is_nothrow_move_constructible<_lease_t>::value, "leases can be moved into containers");
+  static_assert(std::is_nothrow_move_assignable<_lease_t>::value, "leases can be moved into containers");
+
+  sqlpp::connection_pool_config_t config;
+  config.max_size = 2;
+  config.wait_timeout = std::chrono::milliseconds(10);
+
+  // Leases are handed out and returned
+  {
+    sqlpp::connection_pool<MockDb> pool(config, [] { return std::unique_ptr<MockDb>(new MockDb()); });
+    {
+      auto db = pool.acquire();
+      db(select(t.alpha).from(t).unconditionally());
+      require(pool.metrics().leases_in_use == 1, "one lease expected");
+    }
+    require(pool.metrics().leases_in_use == 0, "lease should have been returned");
+
+    // The same thread gets the same connection again
+    MockDb* first = nullptr;
+    {
+      auto db = pool.acquire();
+      first = &*db;
+    }
+    {
+      auto db = pool.acquire();
+      require(first == &*db, "connection affinity expected");
+    }
+    require(pool.metrics().connections_created == 1, "one connection expected");
+  }
+
+  // Exhausted pools time out
+  {
+    sqlpp::connection_pool<MockDb> pool(config, [] { return std::unique_ptr<MockDb>(new MockDb()); });
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    try
+    {
+      pool.acquire();
+      throw std::logic_error("exhausted pool should time out");
+    }
+    catch (const sqlpp::exception&)
+    {
+    }
+    require(pool.metrics().timeouts == 1, "one timeout expected");
+
+    // invalidated connections are replaced
+    a.invalidate();
+    auto c = pool.acquire();
+    require(pool.metrics().connections_dropped == 1, "one dropped connection expected");
+    require(pool.metrics().connections_created == 3, "replacement connection expected");
+  }
+
+  // Idle connections are validated
+  {
+    auto validation_config = config;
+    validation_config.validate_after = std::chrono::milliseconds(0);
+    sqlpp::connection_pool<MockDb> pool(validation_config, [] { return std::unique_ptr<MockDb>(new MockDb()); },
+                                        [](MockDb&) { return false; });
+    pool.acquire();
+    pool.acquire();
+    require(pool.metrics().validation_failures == 1, "failed validation expected");
+    require(pool.metrics().connections_created == 2, "reconnect expected");
+  }
+
+  // Prepared statements stay with the connection
+  {
+    sqlpp::connection_pool<MockDb> pool(config, [] { return std::unique_ptr<MockDb>(new MockDb()); });
+    const auto tmpl = sqlpp::make_statement_template(select(t.alpha).from(t).where(t.alpha == parameter(t.alpha)));
+    {
+      auto db = pool.acquire();
+      auto handle = db.bind(tmpl);
+      handle.params.alpha = 17;
+      db(handle);
+    }
+    {
+      auto db = pool.acquire();
+      auto handle = db.bind(tmpl);
+      handle.params.alpha = 42;
+      db(handle);
+    }
+  }
+
+  // Many threads share a few connections
+  {
+    auto threaded_config = config;
+    threaded_config.max_size = 3;
+    threaded_config.wait_timeout = std::chrono::milliseconds(10000);
+    std::atomic<int> created{0};
+    sqlpp::connection_pool<MockDb> pool(threaded_config, [&created] {
+      ++created;
+      return std::unique_ptr<MockDb>(new MockDb());
+    });
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i)
+    {
+      threads.emplace_back([&pool] {
+        for (int k = 0; k < 200; ++k)
+        {
+          auto db = pool.acquire();
+          db->execute("SELECT 1");
+        }
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+
+    const auto metrics = pool.metrics();
+    require(metrics.leases_in_use == 0, "all leases should have been returned");
+    require(metrics.total_leases == 8 * 200, "unexpected number of leases");
+    require(created <= 3, "pool must not exceed its size");
+    std::cerr << "waits: " << metrics.waits << ", wait time: " << metrics.total_wait_time.count() << "us" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include "MockRowsDb.h"
+#include <sqlpp11/instrumented.h>
+#include <sqlpp11/sqlpp11.h>
+#include <vector>
+
+namespace
+{
+  struct FailingDb : public MockRowsDb
+  {
+    FailingDb() : MockRowsDb({})
+    {
+    }
+
+    template <typename Insert>
+    size_t insert(const Insert&)
+    {
+      throw sqlpp::exception("duplicate key");
+    }
+  };
+
+  struct InsertIdDb : public MockRowsDb
+  {
+    InsertIdDb() : MockRowsDb({})
+    {
+    }
+
+    template <typename Insert>
+    size_t insert(const Insert&)
+    {
+      return 4711;  // the last insert id
+    }
+  };
+}
+
+int Instrumented(int, char* [])
+{
+  const auto t = test::TabBar{};
+
+  // Without a sink, calls are merely forwarded
+  {
+    MockRowsDb db({1, 2, 3});
+    sqlpp::instrumented<MockRowsDb> idb(db);
+    int64_t sum = 0;
+    for (const auto& row : idb(select(t.alpha).from(t).unconditionally()))
+    {
+      sum += row.alpha;
+    }
+    if (idb.enabled() or sum != 6 or db._selects != 1)
+      throw std::runtime_error("disabled instrumentation changed the results");
+  }
+
+  MockRowsDb db({1, 2, 3});
+  std::vector<sqlpp::execution_timing_t> timings;
+  sqlpp::instrumented<MockRowsDb> idb(db, [&](const sqlpp::execution_timing_t& timing) { timings.push_back(timing); });
+
+  // Selects are reported once the result is exhausted
+  {
+    db._delay = std::chrono::milliseconds{10};
+    auto result = idb(select(t.alpha).from(t).unconditionally());
+    if (not timings.empty())
+      throw std::runtime_error("select reported too early");
+    for (const auto& row : result)
+    {
+      (void)row;
+    }
+    if (timings.size() != 1)
+      throw std::runtime_error("select was not reported");
+    const auto& timing = timings.front();
+    if (timing.call != sqlpp::instrumented_call::select or timing.rows != 3 or timing.failed)
+      throw std::runtime_error("unexpected select timing");
+    if (timing.sql_bytes == 0 or timing.statement_id == 0)
+      throw std::runtime_error("select was not serialized");
+    if (timing.execution < db._delay or timing.first_row < timing.execution)
+      throw std::runtime_error("unexpected select durations");
+    db._delay = std::chrono::milliseconds{0};
+  }
+
+  // Abandoned results are reported with the rows fetched so far
+  {
+    timings.clear();
+    {
+      auto result = idb(select(t.alpha).from(t).unconditionally());
+      result.pop_front();
+    }
+    if (timings.size() != 1 or timings.front().rows != 2)
+      throw std::runtime_error("abandoned select was not reported");
+  }
+
+  // Other statements are reported right away
+  {
+    timings.clear();
+    idb(insert_into(t).set(t.beta = "cheesecake", t.gamma = true));
+    idb(update(t).set(t.gamma = false).unconditionally());
+    idb(remove_from(t).unconditionally());
+    idb.execute("VACUUM");
+    if (timings.size() != 4 or timings[0].call != sqlpp::instrumented_call::insert or
+        timings[1].call != sqlpp::instrumented_call::update or timings[2].call != sqlpp::instrumented_call::remove or
+        timings[3].call != sqlpp::instrumented_call::execute or timings[3].sql_bytes != 6)
+      throw std::runtime_error("unexpected statement timings");
+  }
+
+  // Prepared statements are serialized once
+  {
+    timings.clear();
+    auto prepared = idb.prepare(insert_into(t).set(t.beta = parameter(t.beta), t.gamma = true));
+    prepared.params.beta = "cheesecake";
+    idb(prepared);
+    if (timings.size() != 2 or timings[0].call != sqlpp::instrumented_call::prepare_insert or
+        timings[0].sql_bytes == 0 or timings[1].call != sqlpp::instrumented_call::run_prepared_insert or
+        timings[1].sql_bytes != 0)
+      throw std::runtime_error("unexpected prepared statement timings");
+  }
+
+  // Transactions
+  {
+    timings.clear();
+    auto tx = start_transaction(idb);
+    tx.commit();
+    if (timings.size() != 2 or timings[0].call != sqlpp::instrumented_call::start_transaction or
+        timings[1].call != sqlpp::instrumented_call::commit_transaction or db._committed_transactions != 1)
+      throw std::runtime_error("unexpected transaction timings");
+  }
+
+  // Failures are reported, too
+  {
+    FailingDb failing;
+    std::size_t failures = 0;
+    sqlpp::instrumented<FailingDb> ifailing(failing, [&](const sqlpp::execution_timing_t& timing)
+                                           {
+                                             if (timing.failed)
+                                               ++failures;
+                                           });
+    try
+    {
+      ifailing(insert_into(t).set(t.beta = "cheesecake", t.gamma = true));
+      throw std::runtime_error("failure was swallowed");
+    }
+    catch (const sqlpp::exception&)
+    {
+    }
+    if (failures != 1)
+      throw std::runtime_error("failure was not reported");
+  }
+
+  // Insert ids are not reported as affected rows
+  {
+    InsertIdDb ids;
+    std::vector<sqlpp::execution_timing_t> reported;
+    sqlpp::instrumented<InsertIdDb> iids(ids, [&](const sqlpp::execution_timing_t& timing)
+                                         {
+                                           reported.push_back(timing);
+                                         });
+    if (iids(insert_into(t).set(t.beta = "cheesecake", t.gamma = true)) != 4711)
+      throw std::runtime_error("insert id was not returned");
+    if (reported.size() != 1 or reported.front().rows != 0)
+      throw std::runtime_error("insert id was reported as affected rows");
+  }
+
+  // Throwing sinks do not turn successful statements into failed ones
+  {
+    MockRowsDb rows({1, 2, 3});
+    std::vector<sqlpp::execution_timing_t> reported;
+    sqlpp::instrumented<MockRowsDb> ithrowing(rows, [&](const sqlpp::execution_timing_t& timing)
+                                              {
+                                                reported.push_back(timing);
+                                                throw std::runtime_error("sink failed");
+                                              });
+    try
+    {
+      ithrowing(insert_into(t).set(t.beta = "cheesecake", t.gamma = true));
+      throw std::logic_error("sink exception was swallowed");
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    if (reported.size() != 1 or reported.front().failed)
+      throw std::runtime_error("successful insert was reported as failed");
+
+    // Reports from the destructor of an abandoned result are dropped
+    {
+      auto result = ithrowing(select(t.alpha).from(t).unconditionally());
+      result.pop_front();
+    }
+    if (reported.size() != 2)
+      throw std::runtime_error("abandoned select was not reported");
+  }
+
+  return 0;
+}
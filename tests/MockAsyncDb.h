@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SQLPP_MOCK_ASYNC_DB_H
+#define SQLPP_MOCK_ASYNC_DB_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sqlpp11/async.h>
+#include "MockDb.h"
+
+// Runs tasks on a few worker threads, the destructor waits for pending tasks
+class MockThreadPool
+{
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::deque<std::function<void()>> _tasks;
+  bool _stopped = false;
+  std::vector<std::thread> _workers;
+
+public:
+  MockThreadPool(std::size_t size = 2)
+  {
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      _workers.emplace_back([this] {
+        while (true)
+        {
+          std::function<void()> task;
+          {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this] { return _stopped or not _tasks.empty(); });
+            if (_tasks.empty())
+              return;
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+          }
+          task();
+        }
+      });
+    }
+  }
+
+  ~MockThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stopped = true;
+    }
+    _cv.notify_all();
+    for (auto& worker : _workers)
+      worker.join();
+  }
+
+  void operator()(std::function<void()> task)
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _tasks.push_back(std::move(task));
+    }
+    _cv.notify_one();
+  }
+};
+
+// Implements the asynchronous connector interface by completing on a thread pool
+struct MockAsyncDb : public MockDb
+{
+  MockThreadPool _pool;
+  std::vector<std::string> _sent;  // in the order of submission
+
+  template <typename T>
+  auto async(const T& t) -> decltype(sqlpp::async(*this, t))
+  {
+    return sqlpp::async(*this, t);
+  }
+
+  template <typename Select>
+  sqlpp::async_t<result_t> async_select(const Select& x)
+  {
+    _serializer_context_t context;
+    ::sqlpp::serialize(x, context);
+    std::cout << "Running async select call with\n" << context.str() << std::endl;
+    _sent.push_back("select");
+    return _complete(result_t{});
+  }
+
+  template <typename Insert>
+  sqlpp::async_t<size_t> async_insert(const Insert& x)
+  {
+    _serializer_context_t context;
+    ::sqlpp::serialize(x, context);
+    std::cout << "Running async insert call with\n" << context.str() << std::endl;
+    _sent.push_back("insert");
+    return _complete(size_t{1});
+  }
+
+  template <typename Update>
+  sqlpp::async_t<size_t> async_update(const Update& x)
+  {
+    _serializer_context_t context;
+    ::sqlpp::serialize(x, context);
+    std::cout << "Running async update call with\n" << context.str() << std::endl;
+    _sent.push_back("update");
+    return _complete(size_t{1});
+  }
+
+  template <typename Remove>
+  sqlpp::async_t<size_t> async_remove(const Remove& x)
+  {
+    _serializer_context_t context;
+    ::sqlpp::serialize(x, context);
+    std::cout << "Running async remove call with\n" << context.str() << std::endl;
+    _sent.push_back("remove");
+    return _complete(size_t{1});
+  }
+
+private:
+  template <typename T>
+  sqlpp::async_t<T> _complete(T value)
+  {
+    sqlpp::async_promise_t<T> promise;
+    auto result = promise.get_async();
+    _pool([promise, value]() mutable { promise.set_value(std::move(value)); });
+    return result;
+  }
+};
+
+#endif
@@ -32,6 +32,7 @@
 #include <sqlpp11/schema.h>
 #include <sqlpp11/serialize.h>
 #include <sqlpp11/serializer_context.h>
+#include <sqlpp11/transaction.h>
 #include <sstream>
 
 template <bool enforceNullResultTreatment>
@@ -122,6 +123,7 @@ struct MockDbT : public sqlpp::connection
   template <typename T>
   auto operator()(const T& t) -> decltype(this->_run(t, sqlpp::run_check_t<_serializer_context_t, T>{}))
   {
+    ++_executed_statements;
     return _run(t, sqlpp::run_check_t<_serializer_context_t, T>{});
   }
 
@@ -244,6 +246,46 @@ struct MockDbT : public sqlpp::connection
   {
     return {name};
   }
+
+  void start_transaction()
+  {
+    start_transaction(::sqlpp::isolation_level::undefined, ::sqlpp::transaction_access::read_write);
+  }
+
+  void start_transaction(::sqlpp::isolation_level level, ::sqlpp::transaction_access access)
+  {
+    _isolation_level = level;
+    _transaction_access = access;
+    ++_started_transactions;
+  }
+
+  void commit_transaction()
+  {
+    if (_commit_conflicts > 0)
+    {
+      --_commit_conflicts;
+      throw ::sqlpp::transaction_conflict(::sqlpp::transaction_conflict::reason::serialization_failure,
+                                          "could not serialize access");
+    }
+    ++_committed_transactions;
+  }
+
+  void rollback_transaction(bool)
+  {
+    ++_rolled_back_transactions;
+  }
+
+  void report_rollback_failure(const std::string&) noexcept
+  {
+  }
+
+  ::sqlpp::isolation_level _isolation_level = ::sqlpp::isolation_level::undefined;
+  ::sqlpp::transaction_access _transaction_access = ::sqlpp::transaction_access::read_write;
+  size_t _started_transactions = 0;
+  size_t _committed_transactions = 0;
+  size_t _rolled_back_transactions = 0;
+  size_t _commit_conflicts = 0;  // the next commits throw a transaction_conflict
+  size_t _executed_statements = 0;
 };
 
 using MockDb = MockDbT<false>;
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2016, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SQLPP_MOCK_ROWS_DB_H
+#define SQLPP_MOCK_ROWS_DB_H
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+#include "MockDb.h"
+
+// Yields one row per value, all numeric columns of a row carry the same value (NULL for null_value), text columns
+// are NULL
+struct MockRowsResult
+{
+  static constexpr int64_t null_value = std::numeric_limits<int64_t>::min();
+
+  std::vector<int64_t> _values;
+  std::size_t _next = 0;
+
+  MockRowsResult() = default;
+  MockRowsResult(std::vector<int64_t> values) : _values(std::move(values))
+  {
+  }
+
+  template <typename ResultRow>
+  void next(ResultRow& result_row)
+  {
+    if (_next >= _values.size())
+    {
+      result_row._invalidate();
+      return;
+    }
+    result_row._bind(*this);
+    result_row._validate();
+    ++_next;
+  }
+
+  void _bind_integral_result(std::size_t, int64_t* value, bool* is_null)
+  {
+    *value = _values[_next];
+    *is_null = _values[_next] == null_value;
+  }
+
+  void _bind_floating_point_result(std::size_t, double* value, bool* is_null)
+  {
+    *value = static_cast<double>(_values[_next]);
+    *is_null = _values[_next] == null_value;
+  }
+
+  void _bind_text_result(std::size_t, const char** text, std::size_t* len)
+  {
+    *text = nullptr;
+    *len = 0;
+  }
+};
+
+struct MockRowsDb : public MockDb
+{
+  std::vector<int64_t> _values;
+  std::size_t _selects = 0;
+  std::chrono::milliseconds _delay{0};  // simulates the time the database takes to answer
+
+  MockRowsDb(std::vector<int64_t> values) : _values(std::move(values))
+  {
+  }
+
+  template <typename T>
+  auto operator()(const T& t) -> decltype(t._run(*this))
+  {
+    ++_executed_statements;
+    return t._run(*this);
+  }
+
+  template <typename Select>
+  MockRowsResult select(const Select&)
+  {
+    ++_selects;
+    if (_delay.count())
+      std::this_thread::sleep_for(_delay);
+    return MockRowsResult{_values};
+  }
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include "MockAsyncDb.h"
+#include <sqlpp11/pipeline.h>
+#include <sqlpp11/sqlpp11.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // Offers the pipeline mode on top of the asynchronous interface
+  struct MockPipelineDb : public MockAsyncDb
+  {
+    void begin_pipeline()
+    {
+      _sent.push_back("begin");
+    }
+
+    void end_pipeline()
+    {
+      _sent.push_back("end");
+    }
+  };
+}
+
+int Pipeline(int, char* [])
+{
+  const auto t = test::TabBar{};
+
+  // Connectors with pipeline mode send all statements in order before waiting for results
+  {
+    MockPipelineDb db;
+    auto p = sqlpp::pipeline(db)
+                 .add(insert_into(t).set(t.beta = "cheesecake", t.gamma = true))
+                 .add(update(t).set(t.gamma = false).where(t.alpha == 7))
+                 .add(select(all_of(t)).from(t).where(t.alpha == 7))
+                 .add(remove_from(t).where(t.alpha == 7));
+    static_assert(decltype(p)::is_native(), "MockPipelineDb supports pipelining");
+    static_assert(decltype(p)::size() == 4, "four statements expected");
+    auto results = p.run();
+    if (std::get<0>(results) != 1 or std::get<1>(results) != 1 or std::get<3>(results) != 1)
+      throw std::runtime_error("unexpected number of affected rows");
+    for (const auto& row : std::get<2>(results))
+    {
+      std::cerr << row.alpha << std::endl;
+    }
+    if (db._sent != std::vector<std::string>{"begin", "insert", "update", "select", "remove", "end"})
+      throw std::runtime_error("statements were not sent in order in pipeline mode");
+  }
+
+  // Asynchronous connectors without pipeline mode might overlap statements, they are executed one after the other
+  {
+    MockAsyncDb db;
+    auto p = sqlpp::pipeline(db)
+                 .add(insert_into(t).set(t.beta = "cheesecake", t.gamma = true))
+                 .add(select(t.alpha).from(t).unconditionally());
+    static_assert(not decltype(p)::is_native(), "MockAsyncDb does not support pipelining");
+    auto results = p.run();
+    (void)results;
+    if (not db._sent.empty())
+      throw std::runtime_error("statements were run asynchronously without pipeline mode");
+  }
+
+  // Other connectors execute the statements one after the other
+  {
+    MockDb db;
+    auto p = sqlpp::pipeline(db)
+                 .add(insert_into(t).set(t.beta = "cheesecake", t.gamma = true))
+                 .add(select(t.alpha).from(t).unconditionally());
+    static_assert(not decltype(p)::is_native(), "MockDb does not support pipelining");
+    auto results = p.run();
+    for (const auto& row : std::get<1>(results))
+    {
+      std::cerr << row.alpha << std::endl;
+    }
+  }
+
+  return 0;
+}
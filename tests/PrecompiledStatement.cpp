@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "PrecompiledStatement.h"
+#include <stdexcept>
+
+namespace
+{
+  const auto tab = test::TabBar{};
+}
+
+int PrecompiledStatement(int, char* [])
+{
+  MockDb db = {};
+
+  const auto select_by_alpha = select(all_of(tab)).from(tab).where(tab.alpha == parameter(tab.alpha));
+
+  // serialization yields the same text as without the extern declarations
+  {
+    MockDb::_serializer_context_t expected;
+    serialize(select_by_alpha, expected);
+    MockDb::_serializer_context_t context;
+    sqlpp::precompiled_statement_t<MockDb, test::select_by_alpha_t>::serialize(select_by_alpha, context);
+    if (context.str() != expected.str())
+      throw std::runtime_error("unexpected serialization: " + context.str());
+  }
+
+  // direct execution
+  {
+    const auto executed = db._executed_statements;
+    sqlpp::precompiled_run(db, insert_into(tab).set(tab.gamma = true));
+    if (db._executed_statements != executed + 1)
+      throw std::runtime_error("insert was not executed");
+
+    for (const auto& row : sqlpp::precompiled_run(db, select(all_of(tab)).from(tab).unconditionally()))
+    {
+      (void)row.alpha;
+    }
+  }
+
+  // prepared statements
+  {
+    auto prepared_select = sqlpp::precompiled_prepare(db, select_by_alpha);
+    prepared_select.params.alpha = 17;
+    for (const auto& row : sqlpp::precompiled_run(db, prepared_select))
+    {
+      (void)row.alpha;
+    }
+
+    auto prepared_insert = sqlpp::precompiled_prepare(db, insert_into(tab).set(tab.gamma = parameter(tab.gamma)));
+    prepared_insert.params.gamma = true;
+    sqlpp::precompiled_run(db, prepared_insert);
+  }
+
+  return 0;
+}
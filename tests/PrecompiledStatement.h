@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SQLPP_TEST_PRECOMPILED_STATEMENT_H
+#define SQLPP_TEST_PRECOMPILED_STATEMENT_H
+
+#include "Sample.h"
+#include "MockDb.h"
+#include <sqlpp11/precompiled_statement.h>
+#include <sqlpp11/sqlpp11.h>
+
+namespace test
+{
+  using select_by_alpha_t =
+      decltype(select(all_of(TabBar{})).from(TabBar{}).where(TabBar{}.alpha == parameter(TabBar{}.alpha)));
+  using select_all_t = decltype(select(all_of(TabBar{})).from(TabBar{}).unconditionally());
+  using insert_t = decltype(insert_into(TabBar{}).set(TabBar{}.gamma = true));
+  using insert_gamma_t = decltype(insert_into(TabBar{}).set(TabBar{}.gamma = parameter(TabBar{}.gamma)));
+}
+
+// Instantiated in PrecompiledStatementInstances.cpp, which is compiled into a separate library
+SQLPP_EXTERN_STATEMENT(MockDb, test::select_by_alpha_t)
+SQLPP_EXTERN_STATEMENT(MockDb, test::insert_gamma_t)
+SQLPP_EXTERN_STATEMENT(MockDb, test::select_all_t)
+SQLPP_EXTERN_STATEMENT(MockDb, test::insert_t)
+
+#endif
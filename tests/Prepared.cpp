@@ -28,6 +28,27 @@
 #include "is_regular.h"
 #include <sqlpp11/functions.h>
 #include <sqlpp11/select.h>
+#include <sqlpp11/statement_template.h>
+#include <vector>
+
+namespace
+{
+  // Stands in for the prepared statement in a cache, records the parameter values of each execution
+  template <typename ParameterList>
+  struct RecordingPrepared
+  {
+    using _parameter_list_t = ParameterList;
+
+    std::size_t _run(MockDb&) const
+    {
+      _executed_values.push_back(params.alpha.value());
+      return 0;
+    }
+
+    _parameter_list_t params;
+    mutable std::vector<int64_t> _executed_values;
+  };
+}
 
 int Prepared(int, char* [])
 {
@@ -144,5 +165,42 @@ int Prepared(int, char* [])
     P p;
   }
 
+  // Share one statement template, prepare it once per connection, bind values per execution
+  {
+    const auto tmpl = sqlpp::make_statement_template(select(all_of(t)).from(t).where(t.alpha == parameter(t.alpha)));
+    sqlpp::prepared_statement_cache_t<MockDb> cache;
+    auto first = cache.bind(db, tmpl);
+    auto second = cache.bind(db, tmpl);
+    if (cache.size() != 1)
+      throw std::runtime_error("statement template should be prepared once per connection");
+    first.params.alpha = 7;
+    second.params.alpha = 42;
+    for (const auto& row : db(first))
+    {
+      std::cerr << row.alpha << std::endl;
+    }
+    db(second);
+    if (&cache.get(db, tmpl) != &cache.get(db, decltype(tmpl)(tmpl)))
+      throw std::runtime_error("copies of a statement template should share the prepared statement");
+    cache.clear();
+    if (cache.size() != 0)
+      throw std::runtime_error("cleared cache should be empty");
+  }
+
+  // Handles sharing one prepared statement execute with their own values
+  {
+    using P = sqlpp::make_parameter_list_t<decltype(t.alpha == parameter(t.alpha))>;
+    RecordingPrepared<P> prepared;
+    sqlpp::prepared_execution_t<MockDb, RecordingPrepared<P>> first(prepared);
+    sqlpp::prepared_execution_t<MockDb, RecordingPrepared<P>> second(prepared);
+    first.params.alpha = 7;
+    second.params.alpha = 42;
+    db(first);
+    db(second);
+    db(first);
+    if (prepared._executed_values != std::vector<int64_t>{7, 42, 7})
+      throw std::runtime_error("handles did not execute with their own values");
+  }
+
   return 0;
 }
@@ -26,6 +26,7 @@
 #include <iostream>
 #include "Sample.h"
 #include "MockDb.h"
+#include "MockRowsDb.h"
 #include <sqlpp11/sqlpp11.h>
 
 static_assert(not sqlpp::enforce_null_result_treatment_t<MockDb>::value, "MockDb interprets NULL as trivial");
@@ -86,5 +87,25 @@ int Result(int, char* [])
                   "row.alpha interprets null_is_trivial");
   }
 
+  // Fields of a row that does not exist (anymore) cannot be read
+  {
+    MockRowsDb rdb({7});
+    auto result = rdb(select(t.alpha).from(t).unconditionally());
+    const auto& row = result.front();
+    if (row.alpha.value() != 7)
+      throw std::runtime_error("unexpected value");
+    result.pop_front();
+    if (not result.empty())
+      throw std::runtime_error("unexpected number of rows");
+    try
+    {
+      (void)row.alpha.value();
+      throw std::runtime_error("field of non-existing row was read");
+    }
+    catch (const sqlpp::exception&)
+    {
+    }
+  }
+
   return 0;
 }
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include "MockDb.h"
+#include <sqlpp11/routing_connection.h>
+#include <sqlpp11/sqlpp11.h>
+#include <chrono>
+
+namespace
+{
+  // Only moves when told to
+  struct ManualClock
+  {
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+
+    static time_point _now;
+
+    static time_point now()
+    {
+      return _now;
+    }
+  };
+
+  ManualClock::time_point ManualClock::_now;
+}
+
+int RoutingConnection(int, char* [])
+{
+  const auto t = test::TabBar{};
+
+  MockDb primary;
+  MockDb replica1;
+  MockDb replica2;
+  auto config = sqlpp::routing_config_t{};
+  config.read_your_writes = std::chrono::milliseconds{50};
+  sqlpp::routing_connection<MockDb, ManualClock> db(primary, {&replica1, &replica2}, config);
+
+  // Reads are distributed over the replicas
+  for (const auto& row : db(select(all_of(t)).from(t).unconditionally()))
+  {
+    std::cerr << row.alpha << std::endl;
+  }
+  db(select(t.alpha).from(t).unconditionally());
+  if (primary._executed_statements != 0 or replica1._executed_statements != 1 or replica2._executed_statements != 1)
+    throw std::runtime_error("reads were not balanced over the replicas");
+
+  // Dynamic statements work as with any other connection
+  auto s = dynamic_select(db).dynamic_columns(t.alpha).from(t).dynamic_where();
+  s.selected_columns.add(t.beta);
+  s.where.add(t.gamma == true);
+  db(s);
+  if (replica1._executed_statements != 2)
+    throw std::runtime_error("dynamic read was not sent to a replica");
+
+  // Writes go to the primary, subsequent reads too
+  db(update(t).set(t.gamma = false).where(t.alpha == 7));
+  db(select(t.alpha).from(t).unconditionally());
+  if (primary._executed_statements != 2)
+    throw std::runtime_error("write or read after write was not sent to the primary");
+
+  ManualClock::_now += std::chrono::milliseconds{49};
+  db(select(t.alpha).from(t).unconditionally());
+  if (primary._executed_statements != 3)
+    throw std::runtime_error("read within read-your-writes window was not sent to the primary");
+
+  ManualClock::_now += std::chrono::milliseconds{1};
+  db(select(t.alpha).from(t).unconditionally());
+  if (primary._executed_statements != 3)
+    throw std::runtime_error("read after read-your-writes window was sent to the primary");
+
+  // Everything within a transaction goes to the primary
+  {
+    auto tx = start_transaction(db);
+    db(select(t.alpha).from(t).unconditionally());
+    tx.commit();
+  }
+  if (primary._executed_statements != 4 or primary._committed_transactions != 1)
+    throw std::runtime_error("read within transaction was not sent to the primary");
+
+  // Prepared statements belong to the primary, prepared selects are not writes
+  ManualClock::_now += std::chrono::milliseconds{100};
+  auto p = db.prepare(select(t.alpha).from(t).where(t.alpha == parameter(t.alpha)));
+  p.params.alpha = 17;
+  db(p);
+  if (primary._executed_statements != 5)
+    throw std::runtime_error("prepared statement was not run on the primary");
+  db(select(t.alpha).from(t).unconditionally());
+  if (primary._executed_statements != 5)
+    throw std::runtime_error("prepared select opened the read-your-writes window");
+
+  auto pi = db.prepare(insert_into(t).set(t.beta = parameter(t.beta), t.gamma = true));
+  pi.params.beta = "cheesecake";
+  db(pi);
+  db(select(t.alpha).from(t).unconditionally());
+  if (primary._executed_statements != 7)
+    throw std::runtime_error("prepared insert did not open the read-your-writes window");
+
+  // A failed commit is rolled back, the transaction ends once
+  ManualClock::_now += std::chrono::milliseconds{100};
+  primary._commit_conflicts = 1;
+  try
+  {
+    auto tx = start_transaction(db);
+    tx.commit();
+    throw std::logic_error("commit conflict was swallowed");
+  }
+  catch (const sqlpp::transaction_conflict&)
+  {
+  }
+  if (primary._rolled_back_transactions != 1)
+    throw std::runtime_error("failed commit was not rolled back");
+  const auto primary_statements = primary._executed_statements;
+  db(select(t.alpha).from(t).unconditionally());
+  if (primary._executed_statements != primary_statements)
+    throw std::runtime_error("read after failed commit was sent to the primary");
+
+  return 0;
+}
@@ -28,12 +28,46 @@
 #include "is_regular.h"
 #include <algorithm>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <sqlpp11/alias_provider.h>
+#include <sqlpp11/arena.h>
 #include <sqlpp11/connection.h>
+#include <sqlpp11/fingerprint.h>
 #include <sqlpp11/functions.h>
 #include <sqlpp11/select.h>
+#include <sqlpp11/verbatim.h>
+#include <sqlpp11/verbatim_table.h>
 #include <sqlpp11/without_table_check.h>
 
+namespace
+{
+  // Counts the allocations, to tell which objects use the arena
+  struct counting_arena_t : public sqlpp::arena_t
+  {
+    sqlpp::monotonic_arena_t _arena;
+    std::size_t _allocations = 0;
+
+    counting_arena_t() = default;
+
+    counting_arena_t(void* buffer, std::size_t size) : _arena(buffer, size)
+    {
+    }
+
+    void* allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      ++_allocations;
+      return _arena.allocate(bytes, alignment);
+    }
+
+    void deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept override
+    {
+      _arena.deallocate(p, bytes, alignment);
+    }
+  };
+}
+
 template <typename Db, typename Column>
 int64_t getColumn(Db&& db, const Column& column)
 {
@@ -199,5 +233,152 @@ int Select(int, char* [])
     for_each_field(row, to_cerr{});
   }
 
+  // Dynamic parts of statements passed an arena, and the dynamic fields of their results, come from the arena
+  {
+    counting_arena_t arena;
+    auto s = sqlpp::with_arena(arena, dynamic_select(db).dynamic_columns(t.alpha).from(t).dynamic_where());
+    s.selected_columns.add(t.beta);
+    s.where.add(t.alpha > 7);
+    s.where.add(t.beta == "cheesecake");
+    if (arena._allocations == 0)
+      throw std::runtime_error("dynamic statement parts should have been allocated from the arena");
+    const auto statement_allocations = arena._allocations;
+    {
+      auto result = db(s);
+      if (arena._allocations == statement_allocations)
+        throw std::runtime_error("dynamic result fields should have been allocated from the arena");
+    }
+    printer.reset();
+    std::cerr << serialize(s, printer).str() << std::endl;
+
+    // Statements built without an arena do not use it
+    const auto allocations = arena._allocations;
+    auto h = dynamic_select(db).dynamic_columns(t.alpha).from(t).dynamic_where();
+    h.where.add(t.alpha > 7);
+    if (arena._allocations != allocations)
+      throw std::runtime_error("statement without arena allocated from the arena");
+  }
+
+  // Copies of statements do not refer to the arena and survive it
+  {
+    std::vector<char> buffer(1 << 16);
+    std::unique_ptr<counting_arena_t> arena(new counting_arena_t(buffer.data(), buffer.size()));
+    std::string expected;
+    auto copy = [&]()
+    {
+      auto s = sqlpp::with_arena(*arena, dynamic_select(db).dynamic_columns(t.alpha).from(t).dynamic_where());
+      s.selected_columns.add(t.beta);
+      s.where.add(t.alpha > 7);
+      const auto allocations = arena->_allocations;
+      auto copy = s;
+      if (arena->_allocations != allocations)
+        throw std::runtime_error("statement copy allocated from the arena");
+      printer.reset();
+      expected = serialize(s, printer).str();
+      return copy;
+    }();
+
+    // free the arena and scribble over its memory
+    arena.reset();
+    std::fill(buffer.begin(), buffer.end(), '\xff');
+
+    printer.reset();
+    if (serialize(copy, printer).str() != expected)
+      throw std::runtime_error("statement copy refers to the arena");
+    copy.where.add(t.beta == "cheesecake");
+  }
+
+  // Copies made by other threads do not use the arena of the original either
+  {
+    counting_arena_t arena;
+    auto s = sqlpp::with_arena(arena, dynamic_select(db).dynamic_columns(t.alpha).from(t).dynamic_where());
+    s.where.add(t.alpha > 7);
+    const auto allocations = arena._allocations;
+    std::thread thread([&]()
+                       {
+                         auto copy = s;
+                         copy.selected_columns.add(t.beta);
+                         copy.where.add(t.beta == "cheesecake");
+                       });
+    thread.join();
+    if (arena._allocations != allocations)
+      throw std::runtime_error("statement copied by another thread allocated from the arena");
+    s.where.add(t.beta == "cheesecake");
+    if (arena._allocations == allocations)
+      throw std::runtime_error("original statement stopped using the arena");
+  }
+
+  // Fingerprints depend on the dynamic parts, but not on literal values
+  {
+    auto make_select = [&]() { return dynamic_select(db).dynamic_columns(t.alpha).from(t).dynamic_where(); };
+    auto s1 = make_select();
+    auto s2 = make_select();
+    if (sqlpp::fingerprint(s1) != sqlpp::fingerprint(s2))
+      throw std::runtime_error("identical statements should have identical fingerprints");
+
+    s1.where.add(t.alpha > 7);
+    s2.where.add(t.alpha > 17);
+    if (sqlpp::fingerprint(s1) != sqlpp::fingerprint(s2))
+      throw std::runtime_error("fingerprints should not depend on literal values");
+
+    s1.selected_columns.add(t.beta);
+    if (sqlpp::fingerprint(s1) == sqlpp::fingerprint(s2))
+      throw std::runtime_error("fingerprints should depend on dynamic columns");
+
+    s2.where.add(t.beta == "cheesecake");
+    s2.selected_columns.add(t.beta);
+    if (sqlpp::fingerprint(s1) == sqlpp::fingerprint(s2))
+      throw std::runtime_error("fingerprints should depend on dynamic conditions");
+  }
+
+  // Fingerprints depend on verbatim text, but not on text values
+  {
+    auto make_select = [&]() { return dynamic_select(db).dynamic_columns(t.alpha).from(t).dynamic_where(); };
+    auto s1 = make_select();
+    auto s2 = make_select();
+    s1.where.add(sqlpp::verbatim<sqlpp::boolean>("tab_bar.alpha > 7"));
+    s2.where.add(sqlpp::verbatim<sqlpp::boolean>("tab_bar.alpha < 7"));
+    if (sqlpp::fingerprint(s1) == sqlpp::fingerprint(s2))
+      throw std::runtime_error("fingerprints should depend on verbatim text");
+
+    auto s3 = make_select();
+    auto s4 = make_select();
+    s3.where.add(t.beta == "cheesecake");
+    s4.where.add(t.beta == "cake");
+    if (sqlpp::fingerprint(s3) != sqlpp::fingerprint(s4))
+      throw std::runtime_error("fingerprints should not depend on text values");
+
+    const auto v1 = select(t.alpha).from(sqlpp::verbatim_table("tab_foo")).unconditionally();
+    const auto v2 = select(t.alpha).from(sqlpp::verbatim_table("tab_bar")).unconditionally();
+    if (sqlpp::fingerprint(v1) == sqlpp::fingerprint(v2))
+      throw std::runtime_error("fingerprints should depend on verbatim tables");
+  }
+
+  // Fingerprints of static statements only differ in values, they are shared by design
+  {
+    if (sqlpp::fingerprint(select(t.alpha).from(t).where(t.alpha == 7)) !=
+        sqlpp::fingerprint(select(t.alpha).from(t).where(t.alpha == 8)))
+      throw std::runtime_error("fingerprints should not depend on literal values");
+  }
+
+  // Re-use a dynamic statement by clearing its dynamic parts
+  {
+    auto s = dynamic_select(db).dynamic_columns(t.alpha).from(t).dynamic_where().dynamic_order_by();
+    const auto empty_fingerprint = sqlpp::fingerprint(s);
+    for (int i = 0; i < 3; ++i)
+    {
+      s.selected_columns.clear();
+      s.where.clear();
+      s.order_by.clear();
+      if (sqlpp::fingerprint(s) != empty_fingerprint)
+        throw std::runtime_error("cleared statement should look like a fresh one");
+      s.selected_columns.add(t.beta);
+      s.where.add(t.alpha > i);
+      s.order_by.add(t.beta.asc());
+      printer.reset();
+      std::cerr << serialize(s, printer).str() << std::endl;
+    }
+  }
+
   return 0;
 }
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include "MockRowsDb.h"
+#include <sqlpp11/sharded_connection.h>
+#include <sqlpp11/sqlpp11.h>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  template <typename Result>
+  std::vector<int64_t> alphas(Result&& result)
+  {
+    std::vector<int64_t> values;
+    for (const auto& row : result)
+    {
+      values.push_back(row.alpha.is_null() ? MockRowsResult::null_value : row.alpha.value());
+    }
+    return values;
+  }
+
+  template <typename Statement>
+  struct is_mergeable;
+
+  template <typename Database, typename... Policies>
+  struct is_mergeable<sqlpp::statement_t<Database, Policies...>>
+      : sqlpp::logic::none_t<sqlpp::detail::shard_is_unmergeable<Policies>::value...>
+  {
+  };
+}
+
+int ShardedConnection(int, char* [])
+{
+  const auto t = test::TabBar{};
+
+  // Distinct values and rows might be present on several shards
+  {
+    using sqlpp::detail::shard_aggregate;
+    using sqlpp::detail::shard_aggregate_of;
+    static_assert(shard_aggregate_of<decltype(count(t.alpha).as(t.alpha))>::value == shard_aggregate::sum, "");
+    static_assert(shard_aggregate_of<decltype(sum(t.alpha).as(t.alpha))>::value == shard_aggregate::sum, "");
+    static_assert(shard_aggregate_of<decltype(count(sqlpp::distinct, t.alpha).as(t.alpha))>::value ==
+                      shard_aggregate::unsupported,
+                  "");
+    static_assert(shard_aggregate_of<decltype(sum(sqlpp::distinct, t.alpha).as(t.alpha))>::value ==
+                      shard_aggregate::unsupported,
+                  "");
+    static_assert(is_mergeable<decltype(select(t.alpha).from(t).unconditionally())>::value, "");
+    static_assert(is_mergeable<decltype(select(t.alpha).flags(sqlpp::all).from(t).unconditionally())>::value, "");
+    static_assert(
+        not is_mergeable<decltype(select(t.alpha).flags(sqlpp::distinct).from(t).unconditionally())>::value, "");
+  }
+
+  MockRowsDb shard0({1, 4, 7});
+  MockRowsDb shard1({2, 5});
+  MockRowsDb shard2({3, 6, 8, 9});
+  sqlpp::sharded_connection<MockRowsDb> db({&shard0, &shard1, &shard2});
+
+  // Rows are returned shard by shard without order_by
+  if (alphas(db(select(t.alpha).from(t).unconditionally())) != std::vector<int64_t>{1, 4, 7, 2, 5, 3, 6, 8, 9})
+    throw std::runtime_error("unexpected rows without order_by");
+  if (shard0._selects != 1 or shard1._selects != 1 or shard2._selects != 1)
+    throw std::runtime_error("select was not sent to all shards");
+
+  // Ordered merge, limit after merge
+  if (alphas(db(select(t.alpha).from(t).unconditionally().order_by(t.alpha.asc()).limit(5u))) !=
+      std::vector<int64_t>{1, 2, 3, 4, 5})
+    throw std::runtime_error("unexpected rows with order_by and limit");
+
+  // Descending order (each shard sends its rows in descending order, too)
+  MockRowsDb desc0({7, 4, 1});
+  MockRowsDb desc1({9, 8, 6, 3});
+  sqlpp::sharded_connection<MockRowsDb> desc_db({&desc0, &desc1});
+  if (alphas(desc_db(select(t.alpha).from(t).unconditionally().order_by(t.alpha.desc()))) !=
+      std::vector<int64_t>{9, 8, 7, 6, 4, 3, 1})
+    throw std::runtime_error("unexpected rows with descending order_by");
+
+  // NULL is sorted as configured
+  {
+    const auto null = MockRowsResult::null_value;
+    MockRowsDb first0({null, 1, 4});
+    MockRowsDb first1({2, 5});
+    sqlpp::sharded_connection<MockRowsDb> first_db({&first0, &first1});
+    if (alphas(first_db(select(t.alpha).from(t).unconditionally().order_by(t.alpha.asc()))) !=
+        std::vector<int64_t>{null, 1, 2, 4, 5})
+      throw std::runtime_error("NULL was not sorted first");
+
+    MockRowsDb last0({1, 4, null});
+    MockRowsDb last1({2, 5});
+    sqlpp::sharded_config_t config;
+    config.nulls = sqlpp::null_order::largest;
+    sqlpp::sharded_connection<MockRowsDb> last_db({&last0, &last1}, config);
+    if (alphas(last_db(select(t.alpha).from(t).unconditionally().order_by(t.alpha.asc()))) !=
+        std::vector<int64_t>{1, 2, 4, 5, null})
+      throw std::runtime_error("NULL was not sorted last");
+  }
+
+  // The shards are queried via the executor, except for the first one
+  {
+    std::vector<std::thread> threads;
+    sqlpp::sharded_config_t config;
+    config.executor = [&threads](std::function<void()> task) { threads.emplace_back(std::move(task)); };
+    sqlpp::sharded_connection<MockRowsDb> pooled_db({&shard0, &shard1, &shard2}, config);
+    const auto values = alphas(pooled_db(select(t.alpha).from(t).unconditionally().order_by(t.alpha.asc())));
+    for (auto& thread : threads)
+      thread.join();
+    if (values != std::vector<int64_t>{1, 2, 3, 4, 5, 6, 7, 8, 9} or threads.size() != 2)
+      throw std::runtime_error("unexpected rows with executor");
+
+    config.executor = [](std::function<void()>) { throw std::runtime_error("executor is full"); };
+    sqlpp::sharded_connection<MockRowsDb> full_db({&shard0, &shard1}, config);
+    bool failed = false;
+    try
+    {
+      full_db(select(t.alpha).from(t).unconditionally());
+    }
+    catch (const std::runtime_error& e)
+    {
+      failed = std::string(e.what()) == "executor is full";
+    }
+    if (not failed)
+      throw std::runtime_error("executor failure was swallowed");
+  }
+
+  // Aggregates are combined
+  {
+    auto result = db(select(count(t.alpha).as(t.alpha), max(t.alpha).as(sqlpp::alias::a),
+                            min(t.alpha).as(sqlpp::alias::b), sum(t.alpha).as(sqlpp::alias::c))
+                         .from(t)
+                         .unconditionally());
+    const auto& row = result.front();
+    // Each shard reports its first value for each column
+    if (row.alpha.value() != 6 or row.a.value() != 3 or row.b.value() != 1 or row.c.value() != 6)
+      throw std::runtime_error("aggregates were not combined");
+    result.pop_front();
+    if (not result.empty())
+      throw std::runtime_error("aggregates yield more than one row");
+  }
+
+  // Dynamic columns
+  {
+    auto s = dynamic_select(db).dynamic_columns(t.alpha).from(t).unconditionally().order_by(t.alpha.asc());
+    s.selected_columns.add(t.gamma);
+    for (const auto& row : db(s))
+    {
+      std::cerr << row.alpha << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include "MockRowsDb.h"
+#include <sqlpp11/single_flight.h>
+#include <sqlpp11/sqlpp11.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+int SingleFlight(int, char* [])
+{
+  const auto t = test::TabBar{};
+
+  sqlpp::connection_pool_config_t config;
+  config.max_size = 8;
+  sqlpp::connection_pool<MockRowsDb> pool(config,
+                                          []
+                                          {
+                                            std::unique_ptr<MockRowsDb> db(new MockRowsDb({1, 2, 3}));
+                                            db->_delay = std::chrono::milliseconds{50};
+                                            return db;
+                                          });
+  sqlpp::single_flight<MockRowsDb> flights(pool);
+
+  // Identical selects issued at the same time share one query
+  {
+    const std::size_t thread_count = 8;
+    std::atomic<bool> go{false};
+    std::atomic<std::size_t> failures{0};
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < thread_count; ++i)
+    {
+      threads.emplace_back([&]
+                           {
+                             while (not go)
+                               std::this_thread::yield();
+                             int64_t sum = 0;
+                             for (const auto& row : flights(select(t.alpha).from(t).where(t.alpha > 0)))
+                             {
+                               sum += row.alpha;
+                             }
+                             if (sum != 6)
+                               ++failures;
+                           });
+    }
+    go = true;
+    for (auto& thread : threads)
+      thread.join();
+
+    const auto metrics = flights.metrics();
+    if (failures != 0)
+      throw std::runtime_error("unexpected shared rows");
+    if (metrics.queries + metrics.coalesced != thread_count or metrics.coalesced == 0)
+      throw std::runtime_error("identical selects were not coalesced");
+  }
+
+  // Later selects are sent again, different selects are not coalesced
+  {
+    const auto queries = flights.metrics().queries;
+    flights(select(t.alpha).from(t).where(t.alpha > 0));
+    flights(select(t.alpha).from(t).where(t.alpha > 1));
+    if (flights.metrics().queries != queries + 2)
+      throw std::runtime_error("unexpected coalescing");
+  }
+
+  // The rows do not depend on the connection
+  {
+    auto result = flights(select(t.alpha).from(t).unconditionally());
+    if (pool.metrics().leases_in_use != 0 or result.front().alpha.value() != 1)
+      throw std::runtime_error("unexpected materialized result");
+  }
+
+  return 0;
+}
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include "MockRowsDb.h"
+#include <sqlpp11/explain.h>
+#include <sqlpp11/instrumented.h>
+#include <sqlpp11/slow_query_recorder.h>
+#include <sqlpp11/sqlpp11.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+  struct ExplainDb : public MockRowsDb
+  {
+    std::vector<std::string> _explained;
+    bool _explain_fails = false;
+
+    ExplainDb() : MockRowsDb({1, 2, 3})
+    {
+    }
+
+    template <typename Insert>
+    size_t insert(const Insert&)
+    {
+      if (_delay.count())
+        std::this_thread::sleep_for(_delay);
+      return 1;
+    }
+
+    std::string explain_prefix()
+    {
+      return "EXPLAIN QUERY PLAN ";
+    }
+
+    sqlpp::explain_plan_t explain(const std::string& sql)
+    {
+      if (_explain_fails)
+        throw sqlpp::exception("cannot explain placeholders");
+      _explained.push_back(sql);
+      return {"SCAN TABLE tab_bar"};
+    }
+  };
+
+  struct PreparedExplainDb : public ExplainDb
+  {
+    sqlpp::bound_values_t _parameters;
+
+    sqlpp::explain_plan_t explain_prepared(const std::string& sql, const sqlpp::bound_values_t& parameters)
+    {
+      _explained.push_back(sql);
+      _parameters = parameters;
+      return {"SEARCH TABLE tab_bar USING INDEX"};
+    }
+  };
+
+  sqlpp::bound_value_t text_value(std::string text)
+  {
+    sqlpp::bound_value_t value;
+    value.text = std::move(text);
+    value.is_text = true;
+    return value;
+  }
+
+  sqlpp::bound_value_t null_value()
+  {
+    sqlpp::bound_value_t value;
+    value.is_null = true;
+    return value;
+  }
+
+  bool starts_with(const std::string& text, const std::string& prefix)
+  {
+    return text.compare(0, prefix.size(), prefix) == 0;
+  }
+}
+
+int SlowQueryRecorder(int, char* [])
+{
+  const auto t = test::TabBar{};
+
+  // Explain uses the connector's prefix
+  {
+    ExplainDb db;
+    const auto plan = sqlpp::explain(db, select(t.alpha).from(t).where(t.alpha == 7));
+    if (plan.size() != 1 or plan.front() != "SCAN TABLE tab_bar" or db._explained.size() != 1 or
+        not starts_with(db._explained.front(), "EXPLAIN QUERY PLAN SELECT "))
+      throw std::runtime_error("unexpected explain: " + db._explained.front());
+
+    sqlpp::instrumented<ExplainDb> idb(db);
+    if (idb.explain(select(t.alpha).from(t).unconditionally()) != plan or db._explained.size() != 2)
+      throw std::runtime_error("instrumented explain was not forwarded");
+    static_assert(sqlpp::has_explain_t<sqlpp::instrumented<ExplainDb>>::value, "");
+    static_assert(not sqlpp::has_explain_t<sqlpp::instrumented<MockRowsDb>>::value, "");
+  }
+
+  // Only statements exceeding the threshold are recorded, with their plan
+  {
+    ExplainDb db;
+    sqlpp::slow_query_recorder_t recorder(std::chrono::milliseconds{5});
+    sqlpp::instrumented<ExplainDb> idb(db);
+    idb.set_slow_query_recorder(&recorder);
+    if (not idb.enabled())
+      throw std::runtime_error("recorder does not enable instrumentation");
+
+    idb(insert_into(t).set(t.beta = "cheesecake", t.gamma = true));
+    db._delay = std::chrono::milliseconds{10};
+    for (const auto& row : idb(select(t.alpha).from(t).where(t.alpha > 1)))
+    {
+      (void)row;
+    }
+    db._delay = std::chrono::milliseconds{0};
+
+    const auto queries = recorder.snapshot();
+    if (queries.size() != 1 or recorder.recorded() != 1)
+      throw std::runtime_error("unexpected number of slow queries");
+    const auto& query = queries.front();
+    if (not starts_with(query.sql, "SELECT ") or query.elapsed < std::chrono::milliseconds{10} or query.failed or
+        query.shape.empty() or not query.parameters.empty())
+      throw std::runtime_error("unexpected slow query: " + query.sql);
+    if (query.plan.size() != 1 or db._explained.size() != 1 or
+        db._explained.front() != "EXPLAIN QUERY PLAN " + query.sql)
+      throw std::runtime_error("slow query was not explained");
+    if (recorder.to_text().find("plan: SCAN TABLE tab_bar\n") == std::string::npos)
+      throw std::runtime_error("unexpected text export: " + recorder.to_text());
+  }
+
+  // Prepared statements are recorded with their parameters, plans are optional
+  {
+    ExplainDb db;
+    db._explain_fails = true;
+    sqlpp::slow_query_recorder_t recorder(std::chrono::nanoseconds{0});
+    sqlpp::instrumented<ExplainDb> idb(db);
+    idb.set_slow_query_recorder(&recorder);
+
+    auto prepared = idb.prepare(insert_into(t).set(t.beta = parameter(t.beta), t.gamma = parameter(t.gamma)));
+    prepared.params.beta = "cheesecake";
+    db._delay = std::chrono::milliseconds{1};
+    idb(prepared);
+    db._delay = std::chrono::milliseconds{0};
+
+    const auto queries = recorder.snapshot();
+    if (queries.empty() or queries.back().sql != queries.front().sql or
+        queries.back().parameters != sqlpp::bound_values_t{text_value("cheesecake"), null_value()})
+      throw std::runtime_error("unexpected prepared slow query");
+    if (not queries.back().plan.empty() or queries.back().explain_error.empty())
+      throw std::runtime_error("prepared statement without explain_prepared yielded a plan");
+  }
+
+  // Results destroyed with pending rows are recorded without explaining them on the busy connection
+  {
+    ExplainDb db;
+    sqlpp::slow_query_recorder_t recorder(std::chrono::milliseconds{5});
+    sqlpp::instrumented<ExplainDb> idb(db);
+    idb.set_slow_query_recorder(&recorder);
+    db._delay = std::chrono::milliseconds{10};
+    {
+      auto result = idb(select(t.alpha).from(t).unconditionally());
+      result.pop_front();
+    }
+    db._delay = std::chrono::milliseconds{0};
+
+    const auto queries = recorder.snapshot();
+    if (queries.size() != 1 or not queries.front().plan.empty() or queries.front().explain_error.empty() or
+        not db._explained.empty())
+      throw std::runtime_error("pending result was explained");
+  }
+
+  // Prepared statements are explained with their parameters if the connector supports it
+  {
+    PreparedExplainDb db;
+    sqlpp::slow_query_recorder_t recorder(std::chrono::nanoseconds{0});
+    sqlpp::instrumented<PreparedExplainDb> idb(db);
+    idb.set_slow_query_recorder(&recorder);
+    static_assert(sqlpp::has_explain_prepared_t<sqlpp::instrumented<PreparedExplainDb>>::value, "");
+    static_assert(not sqlpp::has_explain_prepared_t<sqlpp::instrumented<ExplainDb>>::value, "");
+
+    auto prepared = idb.prepare(insert_into(t).set(t.beta = parameter(t.beta), t.gamma = true));
+    prepared.params.beta = "cheesecake";
+    recorder.clear();
+    db._delay = std::chrono::milliseconds{1};
+    idb(prepared);
+    db._delay = std::chrono::milliseconds{0};
+
+    const auto queries = recorder.snapshot();
+    if (queries.size() != 1 or queries.front().plan != sqlpp::explain_plan_t{"SEARCH TABLE tab_bar USING INDEX"} or
+        db._explained.size() != 1 or db._explained.front() != "EXPLAIN QUERY PLAN " + queries.front().sql or
+        db._parameters != sqlpp::bound_values_t{text_value("cheesecake")})
+      throw std::runtime_error("prepared statement was not explained with its parameters");
+  }
+
+  // Parameters are passed to explain_prepared as they are, and quoted for the text export only
+  {
+    PreparedExplainDb db;
+    sqlpp::slow_query_recorder_t recorder(std::chrono::nanoseconds{0});
+    sqlpp::instrumented<PreparedExplainDb> idb(db);
+    idb.set_slow_query_recorder(&recorder);
+
+    auto prepared = idb.prepare(insert_into(t).set(t.beta = parameter(t.beta), t.gamma = parameter(t.gamma)));
+    prepared.params.beta = "O'Brien";
+    prepared.params.gamma = true;
+    recorder.clear();
+    db._delay = std::chrono::milliseconds{1};
+    idb(prepared);
+    db._delay = std::chrono::milliseconds{0};
+
+    if (db._parameters.size() != 2 or db._parameters[0] != text_value("O'Brien") or db._parameters[1].text != "true")
+      throw std::runtime_error("explain_prepared did not get the raw values");
+    const auto text = recorder.to_text();
+    if (text.find("parameter: 'O''Brien'\nparameter: true\n") == std::string::npos)
+      throw std::runtime_error("unexpected text export: " + text);
+  }
+
+  // Fast prepared statements are not captured
+  {
+    PreparedExplainDb db;
+    sqlpp::slow_query_recorder_t recorder(std::chrono::hours{1});
+    sqlpp::instrumented<PreparedExplainDb> idb(db);
+    idb.set_slow_query_recorder(&recorder);
+    auto prepared = idb.prepare(insert_into(t).set(t.beta = parameter(t.beta), t.gamma = true));
+    prepared.params.beta = "cheesecake";
+    idb(prepared);
+    if (recorder.recorded() != 0 or not db._explained.empty())
+      throw std::runtime_error("fast prepared statement was recorded");
+  }
+
+  // Prepared statements of the same type are recorded with their own text
+  {
+    ExplainDb db;
+    sqlpp::slow_query_recorder_t recorder(std::chrono::nanoseconds{0});
+    sqlpp::instrumented<ExplainDb> idb(db);
+    idb.set_slow_query_recorder(&recorder);
+
+    auto s1 = dynamic_select(idb, t.alpha).from(t).dynamic_where();
+    s1.where.add(t.alpha == 7);
+    auto s2 = dynamic_select(idb, t.alpha).from(t).dynamic_where();
+    s2.where.add(t.beta == "cheesecake");
+    auto p1 = idb.prepare(s1);
+    auto p2 = idb.prepare(s2);
+    static_assert(std::is_same<decltype(p1), decltype(p2)>::value, "same prepared statement type expected");
+    recorder.clear();
+    db._delay = std::chrono::milliseconds{1};
+    for (const auto& row : idb(p1))
+    {
+      (void)row;
+    }
+    for (const auto& row : idb(p2))
+    {
+      (void)row;
+    }
+    db._delay = std::chrono::milliseconds{0};
+
+    const auto queries = recorder.snapshot();
+    if (queries.size() != 2 or queries[0].sql.find("tab_bar.alpha") == std::string::npos or
+        queries[1].sql.find("tab_bar.beta") == std::string::npos)
+      throw std::runtime_error("prepared statements of the same type share their text");
+  }
+
+  // The ring keeps the most recent queries, oldest first
+  {
+    MockRowsDb db({});
+    sqlpp::slow_query_recorder_t recorder(std::chrono::nanoseconds{0}, 2);
+    sqlpp::instrumented<MockRowsDb> idb(db);
+    idb.set_slow_query_recorder(&recorder);
+    db._delay = std::chrono::milliseconds{1};
+    idb.execute("SELECT 1");
+    idb.execute("SELECT 2");
+    idb.execute("SELECT 3");
+
+    const auto queries = recorder.snapshot();
+    if (recorder.recorded() != 3 or queries.size() != 2 or queries[0].sql != "SELECT 2" or
+        queries[1].sql != "SELECT 3" or not queries[0].plan.empty())
+      throw std::runtime_error("unexpected ring contents");
+
+    recorder.clear();
+    idb.set_slow_query_recorder(nullptr);
+    idb.execute("SELECT 4");
+    if (not recorder.snapshot().empty() or idb.enabled())
+      throw std::runtime_error("recorder was not detached");
+  }
+
+  return 0;
+}
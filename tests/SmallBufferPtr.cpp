@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <sqlpp11/detail/small_buffer_ptr.h>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+  int live_objects = 0;
+
+  struct base_t
+  {
+    base_t()
+    {
+      ++live_objects;
+    }
+
+    base_t(const base_t&) noexcept
+    {
+      ++live_objects;
+    }
+
+    virtual ~base_t()
+    {
+      --live_objects;
+    }
+
+    virtual int value() const = 0;
+  };
+
+  // Objects of exactly Size bytes
+  template <std::size_t Size>
+  struct sized_t : public base_t
+  {
+    sized_t(int value) : _value(value)
+    {
+    }
+
+    int value() const override
+    {
+      return _value;
+    }
+
+    int _value;
+    char _payload[Size - sizeof(base_t) - sizeof(int)];
+  };
+
+  struct throwing_move_t : public base_t
+  {
+    throwing_move_t() = default;
+    throwing_move_t(const throwing_move_t&) = default;
+    throwing_move_t(throwing_move_t&&) noexcept(false)
+    {
+    }
+
+    int value() const override
+    {
+      return 3;
+    }
+  };
+
+  using ptr_t = sqlpp::detail::small_buffer_ptr<base_t, 80>;
+  using small_t = sized_t<80>;
+  using large_t = sized_t<88>;
+  static_assert(sizeof(small_t) == 80, "");
+  static_assert(sizeof(large_t) == 88, "");
+
+  void check(bool condition, const char* message)
+  {
+    if (not condition)
+      throw std::runtime_error(message);
+  }
+}
+
+int SmallBufferPtr(int, char* [])
+{
+  // Placement at the boundary
+  {
+    const auto small = ptr_t::make<small_t>(1);
+    const auto large = ptr_t::make<large_t>(2);
+    const auto throwing = ptr_t::make<throwing_move_t>();
+    check(small.is_inline() and small->value() == 1, "80 bytes should be stored inline");
+    check(not large.is_inline() and large->value() == 2, "88 bytes should be stored on the heap");
+    check(not throwing.is_inline(), "objects with throwing move constructors should be stored on the heap");
+    check(not ptr_t{} and not ptr_t{}.is_inline(), "default constructed pointer should be empty");
+  }
+  check(live_objects == 0, "objects were leaked");
+
+  // Copying a heap object clones it
+  {
+    auto original = ptr_t::make<large_t>(7);
+    auto copy = original;
+    check(&*copy != &*original and copy->value() == 7 and original->value() == 7 and not copy.is_inline(),
+          "heap copy should clone the object");
+    check(live_objects == 2, "heap copy should own a second object");
+
+    auto assigned = ptr_t::make<small_t>(1);
+    assigned = original;
+    check(&*assigned != &*original and assigned->value() == 7 and live_objects == 3,
+          "copy assignment should clone the object");
+  }
+  check(live_objects == 0, "objects were leaked");
+
+  // Moving a heap object hands it over
+  {
+    auto original = ptr_t::make<large_t>(7);
+    const auto* object = &*original;
+    auto moved = std::move(original);
+    check(&*moved == object and not original and live_objects == 1, "heap move should hand over the object");
+
+    auto assigned = ptr_t::make<small_t>(1);
+    assigned = std::move(moved);
+    check(&*assigned == object and not moved and live_objects == 1, "move assignment should hand over the object");
+  }
+  check(live_objects == 0, "objects were leaked");
+
+  // Moving an inline object moves it into the target's buffer
+  {
+    auto original = ptr_t::make<small_t>(5);
+    auto moved = std::move(original);
+    check(moved.is_inline() and moved->value() == 5 and &*moved != &*original, "inline move should move the object");
+  }
+  check(live_objects == 0, "objects were leaked");
+
+  // Self-assignment keeps the object
+  {
+    auto small = ptr_t::make<small_t>(1);
+    auto large = ptr_t::make<large_t>(2);
+    auto& small_alias = small;
+    auto& large_alias = large;
+    small = small_alias;
+    large = large_alias;
+    check(small->value() == 1 and large->value() == 2 and live_objects == 2, "copy self-assignment changed the object");
+    small = std::move(small_alias);
+    large = std::move(large_alias);
+    check(small->value() == 1 and large->value() == 2 and live_objects == 2, "move self-assignment changed the object");
+  }
+  check(live_objects == 0, "objects were leaked");
+
+  // Reset destroys the object
+  {
+    auto large = ptr_t::make<large_t>(2);
+    large.reset();
+    check(not large and live_objects == 0, "reset should destroy the object");
+    large.reset();
+  }
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include "MockRowsDb.h"
+#include <sqlpp11/statement_metrics.h>
+#include <sqlpp11/sqlpp11.h>
+#include <thread>
+#include <vector>
+
+int StatementMetrics(int, char* [])
+{
+  const auto f = test::TabFoo{};
+  const auto t = test::TabBar{};
+
+  // Shapes
+  {
+    using select_t = decltype(select(t.alpha).from(t).unconditionally());
+    const auto& select_shape = sqlpp::statement_shape<select_t>();
+    if (select_shape.name != "select tab_bar")
+      throw std::runtime_error("unexpected select shape: " + select_shape.name);
+    if (&select_shape != &sqlpp::statement_shape<select_t>())
+      throw std::runtime_error("shapes must be created once per type");
+
+    using join_t = decltype(select(t.alpha).from(t.join(f).on(t.alpha == f.omega)).unconditionally());
+    const auto& join_shape = sqlpp::statement_shape<join_t>();
+    if (join_shape.name != "select tab_bar,tab_foo" and join_shape.name != "select tab_foo,tab_bar")
+      throw std::runtime_error("unexpected join shape: " + join_shape.name);
+
+    using insert_t = decltype(insert_into(t).set(t.beta = "cheesecake", t.gamma = true));
+    using update_t = decltype(update(t).set(t.gamma = false).unconditionally());
+    using remove_t = decltype(remove_from(t).unconditionally());
+    if (sqlpp::statement_shape<insert_t>().name != "insert tab_bar" or
+        sqlpp::statement_shape<update_t>().name != "update tab_bar" or
+        sqlpp::statement_shape<remove_t>().name != "remove tab_bar")
+      throw std::runtime_error("unexpected statement shapes");
+    if (join_shape.id == select_shape.id or sqlpp::statement_shape<insert_t>().id == select_shape.id)
+      throw std::runtime_error("different statements must have different shapes");
+
+    MockDb db;
+    auto prepared = db.prepare(insert_into(t).set(t.beta = parameter(t.beta), t.gamma = true));
+    using prepared_t = decltype(prepared);
+    using statement_t = decltype(insert_into(t).set(t.beta = parameter(t.beta), t.gamma = true));
+    if (&sqlpp::statement_shape<prepared_t>() != &sqlpp::statement_shape<statement_t>())
+      throw std::runtime_error("prepared statements must share the shape of their statement");
+  }
+
+  // Histogram
+  {
+    sqlpp::latency_histogram_t histogram;
+    if (histogram.percentile(99.0).count() != 0)
+      throw std::runtime_error("empty histogram must report zero");
+    for (int i = 1; i <= 1000; ++i)
+    {
+      histogram.record(std::chrono::microseconds{i});
+    }
+    const auto within = [](std::chrono::nanoseconds value, std::chrono::microseconds expected)
+    {
+      const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(expected).count();
+      return value.count() >= nanos and value.count() <= nanos + nanos / 32;
+    };
+    if (histogram.count() != 1000 or histogram.max() != std::chrono::microseconds{1000} or
+        not within(histogram.percentile(50.0), std::chrono::microseconds{500}) or
+        not within(histogram.percentile(99.0), std::chrono::microseconds{990}) or
+        not within(histogram.percentile(99.9), std::chrono::microseconds{999}) or
+        histogram.percentile(100.0) != std::chrono::microseconds{1000})
+      throw std::runtime_error("unexpected percentiles");
+
+    for (std::uint64_t value = 0; value < (std::uint64_t{1} << 20); value = value * 2 + 1)
+    {
+      const auto index = sqlpp::latency_histogram_t::_index(value);
+      if (sqlpp::latency_histogram_t::_highest_value(index) < value or
+          (index and sqlpp::latency_histogram_t::_highest_value(index - 1) >= value))
+        throw std::runtime_error("value recorded in wrong bucket");
+    }
+  }
+
+  // Recording from many threads
+  {
+    sqlpp::statement_metrics_registry_t registry;
+    using select_t = decltype(select(t.alpha).from(t).unconditionally());
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i)
+    {
+      threads.emplace_back([&]
+                           {
+                             for (int k = 0; k < 10000; ++k)
+                             {
+                               registry.at<select_t>().record(std::chrono::microseconds{k % 100}, 1, k % 10 == 0);
+                             }
+                           });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    const auto snapshot = registry.snapshot();
+    if (snapshot.size() != 1 or snapshot.front().calls != 80000 or snapshot.front().rows != 80000 or
+        snapshot.front().failures != 8000)
+      throw std::runtime_error("lost concurrent records");
+  }
+
+  // Recording instrumented connections
+  {
+    sqlpp::statement_metrics_registry_t registry;
+    MockRowsDb db({1, 2, 3});
+    sqlpp::instrumented<MockRowsDb> idb(db, sqlpp::record_to(registry));
+    for (int i = 0; i < 2; ++i)
+    {
+      for (const auto& row : idb(select(t.alpha).from(t).where(t.alpha > i)))
+      {
+        (void)row;
+      }
+    }
+    idb(insert_into(t).set(t.beta = "cheesecake", t.gamma = true));
+    auto tx = start_transaction(idb);
+    tx.commit();
+
+    const auto snapshot = registry.snapshot();
+    if (snapshot.size() != 2 or snapshot[0].shape != "insert tab_bar" or snapshot[1].shape != "select tab_bar" or
+        snapshot[1].calls != 2 or snapshot[1].rows != 6)
+      throw std::runtime_error("unexpected metrics of instrumented connection");
+    const auto text = registry.to_text();
+    if (text.find("shape=\"select tab_bar\" calls=2 failures=0 rows=6 ") == std::string::npos)
+      throw std::runtime_error("unexpected text snapshot: " + text);
+  }
+
+  return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Sample.h"
+#include <sqlpp11/table_meta.h>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+  constexpr bool equal(const char* lhs, const char* rhs)
+  {
+    return *lhs == *rhs and (*lhs == '\0' or equal(lhs + 1, rhs + 1));
+  }
+}
+
+int TableMeta(int, char* [])
+{
+  using foo_meta = sqlpp::table_meta<test::TabFoo>;
+  using bar_meta = sqlpp::table_meta<test::TabBar>;
+
+  // everything is available at compile time
+  static_assert(equal(foo_meta::name(), "tab_foo"), "");
+  static_assert(foo_meta::size() == 4, "");
+  static_assert(equal(foo_meta::columns[1].name, "epsilon"), "");
+  static_assert(foo_meta::columns[1].data_type == sqlpp::data_type_id::integral, "");
+  static_assert(foo_meta::columns[3].data_type == sqlpp::data_type_id::unsigned_integral, "");
+  static_assert(foo_meta::columns[3].index == 3, "");
+
+  static_assert(equal(bar_meta::columns[0].name, "alpha"), "");
+  static_assert(bar_meta::columns[0].can_be_null, "");
+  static_assert(bar_meta::columns[0].must_not_insert, "");
+  static_assert(bar_meta::columns[0].must_not_update, "");
+  static_assert(not bar_meta::columns[0].require_insert, "");
+  static_assert(bar_meta::columns[2].data_type == sqlpp::data_type_id::boolean, "");
+  static_assert(bar_meta::columns[2].require_insert, "");
+  static_assert(not bar_meta::columns[2].can_be_null, "");
+
+  static_assert(sqlpp::table_meta<test::TabDateTime>::columns[0].data_type == sqlpp::data_type_id::day_point, "");
+  static_assert(sqlpp::table_meta<test::TabDateTime>::columns[1].data_type == sqlpp::data_type_id::time_point, "");
+
+  // and can be iterated at runtime
+  std::size_t index = 0;
+  for (const auto& column : bar_meta::columns)
+  {
+    if (column.index != index++)
+      throw std::runtime_error("unexpected column index");
+  }
+  if (index != bar_meta::size())
+    throw std::runtime_error("unexpected number of columns");
+
+  const auto beta = bar_meta::find("beta");
+  if (beta == nullptr or beta->index != 1 or beta->data_type != sqlpp::data_type_id::text)
+    throw std::runtime_error("could not find beta");
+  if (std::strcmp(sqlpp::to_string(beta->data_type), "text") != 0)
+    throw std::runtime_error("unexpected data type name");
+  if (bar_meta::find("omega") != nullptr)
+    throw std::runtime_error("omega is not a column of tab_bar");
+
+  return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2013-2015, Roland Bock
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "MockDb.h"
+#include <sqlpp11/transaction.h>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace
+{
+  // A connector without isolation levels and access modes
+  struct PlainTransactionDb : public MockDb
+  {
+    void start_transaction()
+    {
+      MockDb::start_transaction();
+    }
+  };
+}
+
+int Transaction(int, char* [])
+{
+  auto policy = sqlpp::retry_policy_t{};
+  policy.initial_backoff = std::chrono::milliseconds{1};
+  policy.max_backoff = std::chrono::milliseconds{2};
+  policy.isolation = sqlpp::isolation_level::serializable;
+  policy.access = sqlpp::transaction_access::read_only;
+
+  // Conflicts are retried, the hints are passed on to the connector
+  {
+    MockDb db;
+    std::size_t calls = 0;
+    const auto result = sqlpp::run_transaction(db,
+                                               [&calls](MockDb&)
+                                               {
+                                                 if (++calls < 3)
+                                                   throw sqlpp::transaction_conflict(
+                                                       sqlpp::transaction_conflict::reason::deadlock, "deadlock");
+                                                 return 42;
+                                               },
+                                               policy);
+    if (result != 42 or calls != 3)
+      throw std::runtime_error("transaction was not retried");
+    if (db._started_transactions != 3 or db._rolled_back_transactions != 2 or db._committed_transactions != 1)
+      throw std::runtime_error("unexpected number of transactions");
+    if (db._isolation_level != sqlpp::isolation_level::serializable or
+        db._transaction_access != sqlpp::transaction_access::read_only)
+      throw std::runtime_error("transaction hints were not passed on");
+  }
+
+  // Conflicts during commit roll back the transaction before retrying
+  {
+    MockDb db;
+    db._commit_conflicts = 1;
+    std::size_t calls = 0;
+    const auto result = sqlpp::run_transaction(db,
+                                               [&calls](MockDb&)
+                                               {
+                                                 ++calls;
+                                                 return 17;
+                                               },
+                                               policy);
+    if (result != 17 or calls != 2)
+      throw std::runtime_error("commit conflict was not retried");
+    if (db._started_transactions != 2 or db._rolled_back_transactions != 1 or db._committed_transactions != 1)
+      throw std::runtime_error("failed commit was not rolled back");
+  }
+
+  // References returned by the function are returned as copies
+  {
+    MockDb db;
+    std::string text = "before";
+    auto result = sqlpp::run_transaction(db, [&text](MockDb&) -> std::string& { return text; });
+    static_assert(std::is_same<decltype(result), std::string>::value, "result should be a copy");
+    text = "after";
+    if (result != "before")
+      throw std::runtime_error("result refers to the function's state");
+  }
+
+  // The last conflict is passed on
+  {
+    MockDb db;
+    std::size_t calls = 0;
+    try
+    {
+      sqlpp::run_transaction(db,
+                             [&calls](MockDb&)
+                             {
+                               ++calls;
+                               throw sqlpp::transaction_conflict(
+                                   sqlpp::transaction_conflict::reason::serialization_failure, "conflict");
+                             },
+                             policy);
+      throw std::runtime_error("conflict was swallowed");
+    }
+    catch (const sqlpp::transaction_conflict& e)
+    {
+      if (e.get_reason() != sqlpp::transaction_conflict::reason::serialization_failure)
+        throw std::runtime_error("unexpected conflict reason");
+    }
+    if (calls != policy.max_attempts or db._committed_transactions != 0)
+      throw std::runtime_error("unexpected number of attempts");
+  }
+
+  // Connectors with start_transaction() only run transactions with the default hints
+  {
+    PlainTransactionDb db;
+    const auto result = sqlpp::run_transaction(db, [](PlainTransactionDb&) { return 3; });
+    if (result != 3 or db._started_transactions != 1 or db._committed_transactions != 1)
+      throw std::runtime_error("transaction without hints did not run");
+    try
+    {
+      sqlpp::run_transaction(db, [](PlainTransactionDb&) { return 3; }, policy);
+      throw std::runtime_error("transaction hints were ignored");
+    }
+    catch (const sqlpp::transaction_conflict&)
+    {
+      throw std::runtime_error("unexpected conflict");
+    }
+    catch (const sqlpp::exception&)
+    {
+    }
+    if (db._started_transactions != 1)
+      throw std::runtime_error("transaction with unsupported hints was started");
+  }
+
+  // Other errors are not retried
+  {
+    MockDb db;
+    std::size_t calls = 0;
+    try
+    {
+      sqlpp::run_transaction(db,
+                             [&calls](MockDb&)
+                             {
+                               ++calls;
+                               throw sqlpp::exception("syntax error");
+                             });
+      throw std::runtime_error("exception was swallowed");
+    }
+    catch (const sqlpp::transaction_conflict&)
+    {
+      throw std::runtime_error("unexpected conflict");
+    }
+    catch (const sqlpp::exception&)
+    {
+    }
+    if (calls != 1 or db._rolled_back_transactions != 1)
+      throw std::runtime_error("unexpected retry");
+  }
+
+  return 0;
+}